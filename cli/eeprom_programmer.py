@@ -22,10 +22,68 @@
 
 import serial
 import serial.tools.list_ports
+import binascii
+import json
+import queue
+import struct
+import threading
 import time
+import zlib
+from concurrent.futures import ThreadPoolExecutor
 from typing import List, Tuple, Dict
 import sys
 
+# Binary protocol frames (see src/protocol.h):
+# SOF CMD SEQ LEN_LO LEN_HI PAYLOAD[LEN] CRC_LO CRC_HI, CRC-16/CCITT-FALSE over CMD..PAYLOAD
+FRAME_SOF = 0xA5
+
+CMD_STATUS = 0x01
+CMD_READ = 0x02
+CMD_WRITE = 0x03
+CMD_VERIFY = 0x04
+CMD_PAGE_CRC = 0x05
+CMD_CRC32 = 0x06
+CMD_READ_RLE = 0x07
+CMD_WRITE_RLE = 0x08
+CMD_BAUD = 0x09
+CMD_SOCKET = 0x0A
+CMD_PROGRESS = 0x0B
+CMD_BLANK_CHECK = 0x0C
+CMD_DUMP = 0x0D
+
+BLANK_FULL = 0x01
+
+STATUS_OK = 0x00
+STATUS_VERIFY_FAILED = 0x05
+STATUS_NAMES = {
+    0x01: 'bad CRC',
+    0x02: 'bad length',
+    0x03: 'bad address',
+    0x04: 'unknown command',
+    0x05: 'verify failed',
+    0x06: 'bad value',
+    0x07: 'busy',
+}
+
+# Largest read answered in one frame
+READ_CHUNK_SIZE = 4096
+# Receive buffer of the device UART (a 64 byte ring, 63 usable), the unanswered frames in flight have to fit
+DEVICE_RX_BUFFER = 63
+
+# Seconds to wait for the prompt after the banner, opening the port resets the board into its bootloader
+READY_TIMEOUT = 3.0
+# Seconds without input after which the reader passes on a partial line that ends in a prompt (':' or '>')
+PROMPT_IDLE = 0.02
+# Seconds between a prompt and the answer, get_hex_value() drops its input 10 ms after the prompt
+PROMPT_SETTLE = 0.02
+# Seconds without input after which an incomplete frame is dropped
+FRAME_STALL = 0.5
+
+# Seconds after CMD_BAUD within which the device expects a valid frame, before it falls back to 115200
+BAUD_CONFIRM_TIME = 1.0
+# Baud rate after reset and after a failed baud rate change
+DEFAULT_BAUD = 115200
+
 
 def find_arduino_ports() -> List[Dict[str, str]]:
     """Find all Arduino devices connected to the system
@@ -126,59 +184,408 @@ def bytes_to_hex_record(address: int, record_type: int, line: List[int]) -> str:
     return f":{byte_count:02X}{addr_hi:02X}{addr_lo:02X}{record_type:02X}{hex_data}{checksum:02X}"
 
 
+def hex_to_memory(hex_data: str) -> Dict[int, int]:
+    """Convert Intel HEX data into a sparse memory map
+
+    Supports data (00), end of file (01), extended segment (02) and extended linear (04) address records.
+    Start address records (03, 05) are ignored. Later records overwrite earlier ones.
+
+    Args:
+        hex_data: Intel HEX format string (can be multiple lines)
+
+    Returns:
+        Dictionary of address to byte value
+
+    Raises:
+        ValueError: If a record is malformed or its checksum does not match
+    """
+    memory = {}
+    base = 0
+    for line in hex_data.splitlines():
+        line = line.strip()
+        if not line:
+            continue
+        if not line.startswith(':'):
+            raise ValueError(f"Missing start character: {line}")
+        record = bytes.fromhex(line[1:])
+        if len(record) < 5 or len(record) != record[0] + 5:
+            raise ValueError(f"Bad record length: {line}")
+        if calculate_checksum(list(record[:-1])) != record[-1]:
+            raise ValueError(f"Checksum mismatch: {line}")
+
+        byte_count, address, record_type = record[0], (record[1] << 8) | record[2], record[3]
+        data = record[4:4 + byte_count]
+        if record_type == 0x00:
+            for i, value in enumerate(data):
+                memory[base + address + i] = value
+        elif record_type == 0x01:
+            break
+        elif record_type == 0x02:
+            base = ((data[0] << 8) | data[1]) << 4
+        elif record_type == 0x04:
+            base = ((data[0] << 8) | data[1]) << 16
+
+    return memory
+
+
+def memory_to_image(memory: Dict[int, int]) -> Tuple[int, bytes]:
+    """Convert a sparse memory map into a contiguous binary image
+
+    Gaps between records are filled with 0xFF.
+
+    Args:
+        memory: Dictionary of address to byte value
+
+    Returns:
+        Tuple of (start address, image bytes)
+    """
+    if not memory:
+        return 0, b''
+    start = min(memory)
+    image = bytearray(b'\xFF' * (max(memory) - start + 1))
+    for address, value in memory.items():
+        image[address - start] = value
+    return start, bytes(image)
+
+
+def load_memory(path: str, address: int = 0) -> Dict[int, int]:
+    """Load an Intel HEX or binary file into a sparse memory map
+
+    Files ending with .bin are loaded as raw binary at the given address, all others as Intel HEX.
+
+    Args:
+        path: File path
+        address: Load address of a binary file
+
+    Returns:
+        Dictionary of address to byte value
+    """
+    if path.lower().endswith('.bin'):
+        with open(path, 'rb') as f:
+            return {address + i: value for i, value in enumerate(f.read())}
+    with open(path, 'r') as f:
+        return hex_to_memory(f.read())
+
+
+def coalesce_pages(memory: Dict[int, int], page_size: int = 64, fill: int = 0xFF) -> List[Tuple[int, bytes]]:
+    """Merge sparse data into whole EEPROM pages
+
+    Every page that holds at least one byte of data is emitted completely, bytes not set by the
+    input are filled with the blank value. Pages without data are left out.
+
+    Args:
+        memory: Dictionary of address to byte value
+        page_size: EEPROM page size
+        fill: Value of bytes not set by the input
+
+    Returns:
+        List of (page address, page bytes) sorted by address
+    """
+    pages = {}
+    for address, value in memory.items():
+        page = address - address % page_size
+        if page not in pages:
+            pages[page] = bytearray([fill] * page_size)
+        pages[page][address - page] = value
+    return [(page, bytes(pages[page])) for page in sorted(pages)]
+
+
+def rle_tokens(data: bytes) -> List[Tuple[bytes, int]]:
+    """Run-length encode data in the CMD_READ_RLE/CMD_WRITE_RLE format, one token per run
+
+    Args:
+        data: Data to encode
+
+    Returns:
+        List of (encoded token, number of bytes it stands for)
+    """
+    tokens = []
+    i = 0
+    while i < len(data):
+        value = data[i]
+        run = 1
+        while run < 257 and i + run < len(data) and data[i + run] == value:
+            run += 1
+        if run >= 2:
+            tokens.append((bytes([value, value, run - 2]), run))
+        else:
+            tokens.append((bytes([value]), 1))
+        i += run
+    return tokens
+
+
+def rle_decode(data: bytes) -> bytes:
+    """Expand CMD_READ_RLE data, two equal bytes in a row are followed by a count of further copies
+
+    Args:
+        data: Run-length encoded data
+
+    Returns:
+        Decoded bytes
+    """
+    result = bytearray()
+    i = 0
+    while i < len(data):
+        value = data[i]
+        if i + 1 < len(data) and data[i + 1] == value:
+            if i + 2 >= len(data):
+                raise EEPROMProgrammerError("Run-length data ends without a count")
+            result += bytes([value]) * (2 + data[i + 2])
+            i += 3
+        else:
+            result.append(value)
+            i += 1
+    return bytes(result)
+
+
+def join_pages(pages: List[Tuple[int, bytes]]) -> List[Tuple[int, bytes]]:
+    """Join consecutive pages into contiguous segments
+
+    Args:
+        pages: List of (address, data) tuples, sorted by address
+
+    Returns:
+        List of (start address, data) tuples
+    """
+    segments = []
+    for address, data in pages:
+        if segments and segments[-1][0] + len(segments[-1][1]) == address:
+            segments[-1] = (segments[-1][0], segments[-1][1] + data)
+        else:
+            segments.append((address, data))
+    return segments
+
+
+def pages_to_hex(pages: List[Tuple[int, bytes]]) -> str:
+    """Convert pages into Intel HEX with one data record per page
+
+    Extended linear address records are inserted when a page lies above 64 KB.
+
+    Args:
+        pages: List of (page address, page bytes) sorted by address
+
+    Returns:
+        Intel HEX format string including the end of file record
+    """
+    lines = []
+    base = 0
+    for address, data in pages:
+        if address >> 16 != base:
+            base = address >> 16
+            lines.append(bytes_to_hex_record(0, 0x04, [base >> 8, base & 0xFF]))
+        lines.append(bytes_to_hex_record(address & 0xFFFF, 0x00, list(data)))
+    lines.append(bytes_to_hex_record(0, 0x01, []))
+    return '\n'.join(lines) + '\n'
+
+
+class ProgressBar:
+    """Single line progress bar with transfer rate and ETA, redrawn in place"""
+
+    def __init__(self, width: int = 30):
+        """Create an empty progress bar
+
+        Args:
+            width: Number of characters of the bar itself
+        """
+        self.width = width
+        self.shown = False
+
+    def update(self, done: int, total: int, rate: int, label: str = '', errors: int = 0):
+        """Redraw the bar
+
+        Args:
+            done: Bytes processed
+            total: Bytes of the whole operation
+            rate: Bytes per second
+            label: Text in front of the bar
+            errors: Errors so far, shown if not zero
+        """
+        fraction = done / total if total else 1.0
+        filled = int(fraction * self.width)
+        eta = f"ETA {(total - done) / rate:4.0f} s" if rate else "ETA    ? s"
+        status = f"\r{label} [{'#' * filled}{'.' * (self.width - filled)}] {fraction * 100:3.0f}% {rate:5d} B/s {eta}"
+        if errors:
+            status += f" {errors} errors"
+        sys.stdout.write(status)
+        sys.stdout.flush()
+        self.shown = True
+
+    def finish(self):
+        """End the bar line, the next output starts on a new line"""
+        if self.shown:
+            sys.stdout.write('\n')
+            sys.stdout.flush()
+            self.shown = False
+
+
 class EEPROMProgrammerError(Exception):
     """Custom exception for EEPROM programmer errors"""
     pass
 
 
 class ArduinoClient:
-    def __init__(self, port: str, baudrate: int = 115200, timeout: float = 1.0):
-        """Initialize EEPROM programmer client
+    def __init__(self, port: str, baudrate: int = 115200, timeout: float = 5.0):
+        """Initialize EEPROM programmer client and wait until the programmer is ready
+
+        A background thread reads the serial port: response frames go to the command waiting for their
+        sequence number, text lines and unsolicited frames (CMD_PROGRESS) to an event queue. The programmer
+        is ready once the prompt after its banner arrives, a board that did not reset is probed with CMD_STATUS.
 
         Args:
             port: Serial port name (e.g., 'COM3' or '/dev/ttyUSB0')
             baudrate: Baud rate (default: 115200)
-            timeout: Serial timeout in seconds (default: 1.0)
+            timeout: Default seconds to wait for a response (default: 5.0)
         """
-        self.ser = serial.Serial(port, baudrate, timeout=timeout)
-        time.sleep(2)  # Wait for Arduino reset
-        self._clear_buffer()
+        self.ser = serial.Serial(port, baudrate, timeout=PROMPT_IDLE)
+        self.timeout = timeout
+        self._seq = 0
+        self._page_size = 64
+        self._max_payload = 66
+        self._sockets = 1
+        self._lock = threading.Condition()
+        self._pending = {}      # seq -> (cmd, queue of responses)
+        self._in_flight = {}    # seq -> size of the request frame while it is unanswered
+        self._events = queue.Queue()
+        self._ready = threading.Event()
+        self._discard = False
+        self._closing = False
+        self._reader = threading.Thread(target=self._read_loop, name=f"reader {port}", daemon=True)
+        self._reader.start()
+        self.wait_ready()
+
+    def __enter__(self):
+        return self
+
+    def __exit__(self, *exc):
+        self.close()
+
+    def wait_ready(self, timeout: float = READY_TIMEOUT):
+        """Wait for the prompt the programmer prints once it has started, then drop the banner
 
-    def _clear_buffer(self):
-        """Clear the serial input buffer"""
-        self.ser.reset_input_buffer()
-        self.ser.reset_output_buffer()
+        Args:
+            timeout: Seconds to wait for the prompt before probing with CMD_STATUS
 
-    def _send_command(self, cmd: str) -> str:
-        """Send a command and return the response
+        Raises:
+            EEPROMProgrammerError: If neither the prompt nor a response to CMD_STATUS arrives
+        """
+        if not self._ready.wait(timeout):
+            self.status()
+        self._drain_events()
+
+    def _read_loop(self):
+        """Background reader: split the serial input into frames and text lines"""
+        buf = bytearray()
+        line = bytearray()
+        last_input = time.time()
+        while not self._closing:
+            try:
+                chunk = self.ser.read(self.ser.in_waiting or 1)
+            except (serial.SerialException, OSError, TypeError):
+                break
+            if self._discard:
+                with self._lock:
+                    buf.clear()
+                    line.clear()
+                    self._discard = False
+                    self._lock.notify_all()
+                continue
+
+            buf += chunk
+            while buf:
+                if buf[0] != FRAME_SOF:
+                    end = buf.find(FRAME_SOF)
+                    if end < 0:
+                        end = len(buf)
+                    line += buf[:end]
+                    del buf[:end]
+                    while b'\n' in line:
+                        end = line.index(b'\n')
+                        self._on_text(line[:end])
+                        del line[:end + 1]
+                    continue
+                if len(buf) < 5 or len(buf) < 7 + (buf[3] | buf[4] << 8):
+                    break
+                size = 7 + (buf[3] | buf[4] << 8)
+                self._on_frame(bytes(buf[1:size]))
+                del buf[:size]
+
+            if chunk:
+                last_input = time.time()
+            elif buf and time.time() - last_input > FRAME_STALL:
+                del buf[:1]  # Incomplete frame, the rest is skipped up to the next FRAME_SOF
+            elif line.rstrip().endswith((b':', b'>')):
+                self._on_text(line)
+                line.clear()
+
+    def _on_text(self, raw: bytes):
+        """Queue a line of text output, the prompt of the programmer marks it ready"""
+        text = raw.decode(errors='replace').strip()
+        if text:
+            if text.endswith('>'):
+                self._ready.set()
+            self._events.put(text)
+
+    def _on_frame(self, body: bytes):
+        """Hand a received frame (without FRAME_SOF) to the command waiting for it, or queue it as an event"""
+        header, payload, crc = body[:4], body[4:-2], body[-2:]
+        cmd, seq, _ = struct.unpack('<BBH', header)
+        valid = len(payload) > 0 and binascii.crc_hqx(header + payload, 0xFFFF) == struct.unpack('<H', crc)[0]
+        self._ready.set()
+        with self._lock:
+            waiting = self._pending.get(seq)
+            if waiting is not None and waiting[0] != cmd:
+                waiting = None
+            if waiting is not None:
+                self._in_flight.pop(seq, None)
+                self._lock.notify_all()
+        if waiting is not None:
+            waiting[1].put((payload[0], payload[1:]) if valid else EEPROMProgrammerError("Response frame CRC mismatch"))
+        elif valid:
+            self._events.put((cmd, seq, payload[0], payload[1:]))
+
+    def _next_event(self, deadline: float):
+        """Get the next text line or unsolicited frame
 
         Args:
-            cmd: Single character command
+            deadline: time.time() value after which to give up
 
         Returns:
-            Response string from the programmer
+            Line without surrounding whitespace, or tuple of (command, sequence number, status, data)
         """
-        self._clear_buffer()
-        self.ser.write(cmd.encode())
-        time.sleep(0.1)
-
-        response = []
-        timeout = time.time() + 5  # 5 second timeout
+        try:
+            return self._events.get(timeout=max(deadline - time.time(), 0))
+        except queue.Empty:
+            raise EEPROMProgrammerError("Timeout waiting for Arduino response") from None
 
+    def _drain_events(self):
+        """Drop the text output and unsolicited frames received so far"""
         while True:
-            if self.ser.in_waiting:
-                line = self.ser.readline().decode().strip()
-                if line:  # Only append non-empty lines
-                    response.append(line)
-                    break
+            try:
+                self._events.get_nowait()
+            except queue.Empty:
+                return
+
+    def _flush_input(self):
+        """Drop all input that has not been handled yet, e.g. garbage after a baud rate change"""
+        with self._lock:
+            self._discard = True
+            while self._discard and self._reader.is_alive():
+                self._lock.wait(0.1)
+        self.ser.reset_input_buffer()
+        self._drain_events()
 
-            # Check for timeout
-            if time.time() > timeout:
-                raise EEPROMProgrammerError("Timeout waiting for Arduino response")
+    def _send_command(self, cmd: str) -> str:
+        """Send a command and return the response
 
-            time.sleep(0.1)
+        Args:
+            cmd: Single character command
 
-        return '\n'.join(response)
+        Returns:
+            First line of the response, the echo of the command
+        """
+        self._drain_events()
+        self.ser.write(cmd.encode())
+        return self._read_line()
 
     def _send_hex_value(self, value: int, digits: int = 4) -> None:
         """Send a hex value when prompted
@@ -187,10 +594,11 @@ class ArduinoClient:
             value: Integer value to send
             digits: Number of hex digits (default: 4)
         """
+        while not self._read_line().endswith(':'):
+            pass
+        time.sleep(PROMPT_SETTLE)
         hex_str = f"{value:0{digits}X}"
-        self.ser.write(hex_str.encode())
-        self.ser.write(b'\r\n')
-        time.sleep(0.1)
+        self.ser.write(hex_str.encode() + b'\r\n')
 
     def erase(self, start_addr: int = 0, end_addr: int = 0, pattern: int = 0xFF):
         """Erase EEPROM section with specified pattern
@@ -200,6 +608,9 @@ class ArduinoClient:
             end_addr: End address (default: 0 = full size)
             pattern: Byte pattern to write (default: 0xFF)
         """
+        # Any binary frame makes the programmer report progress as CMD_PROGRESS frames
+        self.status()
+
         # Send initial command
         self._send_command('E')
 
@@ -208,113 +619,810 @@ class ArduinoClient:
         self._send_hex_value(end_addr)
         self._send_hex_value(pattern, digits=2)
 
-        # Wait for completion response
-        timeout = time.time() + 30  # 30 second timeout for erase
+        # Wait for completion response, 30 second timeout for erase
+        self._wait_job("Commands:", time.time() + 30)
 
-        while True:
-            if self.ser.in_waiting:
-                line = self.ser.readline().decode().strip()
-                if line.endswith("Commands:"):
-                    break
-                if line:
-                    print(line)
-
-            # Check for timeout
-            if time.time() > timeout:
-                raise EEPROMProgrammerError("Timeout waiting for erase completion")
+    def _wait_job(self, marker: str, deadline: float):
+        """Print the output of a text command job until a line ends with marker. CMD_PROGRESS frames
+        in between are shown as a progress bar.
 
-            time.sleep(0.1)
-
-    def read(self, start_addr: int = 0) -> List[Tuple[int, List[int]]]:
-        """Dump EEPROM contents
+        Args:
+            marker: End of the last line of the job
+            deadline: time.time() value after which to give up
+        """
+        bar = ProgressBar()
+        while True:
+            try:
+                event = self._next_event(deadline)
+            except EEPROMProgrammerError:
+                bar.finish()
+                raise EEPROMProgrammerError("Timeout waiting for job completion") from None
+
+            if isinstance(event, tuple):
+                cmd, _, _, payload = event
+                if cmd == CMD_PROGRESS and len(payload) >= 13:
+                    operation, address, done, total, rate, errors = struct.unpack('<cHHHHI', payload[:13])
+                    bar.update(done, total, rate, f"{operation.decode()} 0x{address:04X}", errors)
+                continue
+
+            if event.endswith(marker):
+                bar.finish()
+                return
+            bar.finish()
+            print(event)
+
+    def read(self, start_addr: int = 0, length: int = 0) -> List[Tuple[int, List[int]]]:
+        """Dump EEPROM contents with the streaming text dump, without pagination
 
         Args:
             start_addr: Start address for dump (default: 0)
+            length: Number of bytes, 0 for the rest of the EEPROM
 
         Returns:
             List of tuples containing (address, [bytes])
         """
-        self._send_command('D')
+        self._send_command('F')
         self._send_hex_value(start_addr)
+        self._send_hex_value(length)
 
         dump_data = []
-        current_addr = None
-        current_bytes = []
-
         while True:
-            if self.ser.in_waiting:
-                line = self.ser.readline().decode().strip()
+            line = self._read_line()
+            if line.endswith('>'):
+                break
+            if ': ' not in line or line.startswith(('Start', 'Length')):
+                continue
 
-                if line.endswith('>'):
-                    if current_addr is not None and current_bytes:
-                        dump_data.append((current_addr, current_bytes))
-                    break
+            print(line)
+            addr_str, data_str = line.split(': ')
+            dump_data.append((int(addr_str, 16), [int(byte_str, 16) for byte_str in data_str.split()]))
 
-                if not line or line.startswith('Addr'):
-                    continue
+        return dump_data
 
-                if line.startswith('Press'):  # Continue dump after page break
-                    self.ser.write(b' ')
-                    time.sleep(0.1)
-                elif ': ' in line:
-                    print(line)
-                    if current_addr is not None and current_bytes:
-                        dump_data.append((current_addr, current_bytes))
-                    addr_str, data_str = line.split(': ')
-                    current_addr = int(addr_str, 16)
-                    current_bytes = []
-
-                    for byte_str in data_str.split():
-                        if byte_str:
-                            current_bytes.append(int(byte_str, 16))
+    def _read_line(self, timeout: float = None) -> str:
+        """Read one non-empty line from the programmer, unsolicited frames in between are skipped
 
-        return dump_data
+        Args:
+            timeout: Maximum time to wait in seconds (default: the client timeout)
+
+        Returns:
+            Line without surrounding whitespace
+        """
+        deadline = time.time() + (self.timeout if timeout is None else timeout)
+        while True:
+            event = self._next_event(deadline)
+            if isinstance(event, str):
+                return event
 
     def write_hex(self, hex_data: str):
         """Write Intel HEX format data
 
+        Every line is acknowledged by the programmer with ACK or NAK once it is processed,
+        the next line is sent right after that while the EEPROM is still writing.
+
         Args:
             hex_data: Intel HEX format string (can be multiple lines)
 
         Returns:
-            Status message
+            Number of lines rejected by the programmer
         """
         self._send_command('W')
-        time.sleep(0.2)
+        while not self._read_line().startswith('Enter Intel HEX data'):
+            pass
+
+        errors = 0
+        lines = [line.strip() for line in hex_data.strip().split('\n') if line.strip()]
+        if not lines or lines[-1][7:9] != '01':
+            lines.append('')  # Empty line finishes the input
 
-        for line in hex_data.strip().split('\n'):
-            self.ser.write(line.strip().encode() + b'\r\n')
-            time.sleep(0.1)
+        for line in lines:
+            self.ser.write(line.encode() + b'\r\n')
             while True:
-                if self.ser.in_waiting:
-                    line = self.ser.readline().decode().strip()
-                    if line.startswith('Commands'):
-                        break
-                    print(line)
-                else:
+                response = self._read_line()
+                if response == 'ACK':
+                    break
+                if response == 'NAK':
+                    errors += 1
                     break
+                print(response)
+
+        return errors
+
+    def stats(self) -> str:
+        """Read the write cycle statistics collected since the programmer was reset
+
+        Returns:
+            Statistics report: cycle counts, min/mean/max cycle time, polls and histogram
+        """
+        self._send_command('H')
+
+        lines = []
+        while True:
+            line = self._read_line()
+            if line.startswith('Commands'):
+                break
+            lines.append(line)
+        return '\n'.join(lines)
+
+    def counters(self) -> Dict[str, int]:
+        """Read and clear the bus counters and the time per operation (I command)
+
+        Returns:
+            Dictionary with i2c_transactions, i2c_bytes, gpio_writes, data_polls and <operation>_ops and
+            <operation>_us for erase, write, verify, dump and test, empty if the firmware has no counters
+        """
+        self._send_command('I')
+
+        counters = {}
+        while True:
+            line = self._read_line()
+            if line.startswith('Commands'):
+                break
+            name, _, value = line.partition(': ')
+            key = name.lower().replace(' ', '_')
+            if value.endswith(' us'):
+                ops, _, us = value.partition(' ops, ')
+                counters[f"{key}_ops"] = int(ops)
+                counters[f"{key}_us"] = int(us[:-3])
+            elif value.isdigit():
+                counters[key] = int(value)
+        return counters
+
+    def bench(self) -> str:
+        """Run the on-device benchmark of the I2C, read, write and verify layers
+
+        Returns:
+            Benchmark report with us/op and bytes/s for every layer
+        """
+        self._send_command('B')
+
+        lines = []
+        while True:
+            line = self._read_line(30)
+            if line.startswith('Commands'):
+                break
+            lines.append(line)
+        return '\n'.join(lines)
+
+    def bench_host(self, length: int = 4096, rounds: int = 20) -> List[Tuple[str, float, int]]:
+        """Measure end-to-end transfer over the serial port using binary frames
+
+        Nothing is written, the verify benchmark sends the data read before.
+
+        Args:
+            length: Number of bytes for the read and verify benchmarks
+            rounds: Number of status round trips
+
+        Returns:
+            List of (name, seconds, bytes) for status round trip, read and verify
+        """
+        results = []
+        start = time.perf_counter()
+        for _ in range(rounds):
+            self.status()
+        results.append(('Status round trip', (time.perf_counter() - start) / rounds, 0))
+
+        length = min(length, self.status()['size'])
+        start = time.perf_counter()
+        data = self.read_range(0, length)
+        results.append(('Read', time.perf_counter() - start, length))
+
+        start = time.perf_counter()
+        self.verify_range(0, data)
+        results.append(('Verify', time.perf_counter() - start, length))
+        return results
+
+    def submit(self, cmd: int, payload: bytes = b'', timeout: float = None) -> int:
+        """Send a command frame without waiting for its response, see result()
+
+        Several commands can be in flight. A frame is sent once the unanswered frames before it leave room for it
+        in the receive buffer of the device, a frame larger than the buffer only when all others are answered.
+
+        Args:
+            cmd: Command code (CMD_*)
+            payload: Command payload
+            timeout: Seconds to wait for room in the device receive buffer (default: the client timeout)
+
+        Returns:
+            Sequence number of the frame
+        """
+        self._seq = self._seq % 255 + 1  # SEQ 0 is used by unsolicited frames
+        seq = self._seq
+        size = len(payload) + 7
+        deadline = time.time() + (self.timeout if timeout is None else timeout)
+        with self._lock:
+            while self._in_flight and sum(self._in_flight.values()) + size > DEVICE_RX_BUFFER:
+                remaining = deadline - time.time()
+                if remaining <= 0:
+                    raise EEPROMProgrammerError("Timeout waiting for response frame")
+                self._lock.wait(remaining)
+            self._pending[seq] = (cmd, queue.Queue())
+            self._in_flight[seq] = size
+
+        body = struct.pack('<BBH', cmd, seq, len(payload)) + payload
+        crc = binascii.crc_hqx(body, 0xFFFF)
+        self.ser.write(bytes([FRAME_SOF]) + body + struct.pack('<H', crc))
+        return seq
+
+    def result(self, seq: int, timeout: float = None, more: bool = False) -> Tuple[int, bytes]:
+        """Wait for the response to a command sent with submit()
+
+        Args:
+            seq: Sequence number returned by submit()
+            timeout: Timeout in seconds (default: the client timeout)
+            more: Further responses with the same sequence number follow (CMD_DUMP)
+
+        Returns:
+            Tuple of (status, data)
+
+        Raises:
+            EEPROMProgrammerError: If the device reports an error other than a verify mismatch
+        """
+        cmd, responses = self._pending[seq]
+        try:
+            response = responses.get(timeout=self.timeout if timeout is None else timeout)
+        except queue.Empty:
+            response = EEPROMProgrammerError("Timeout waiting for response frame")
+        if isinstance(response, Exception) or not more:
+            self._forget(seq)
+        if isinstance(response, Exception):
+            raise response
+
+        status, data = response
+        if status not in (STATUS_OK, STATUS_VERIFY_FAILED):
+            self._forget(seq)
+            raise EEPROMProgrammerError(f"Command 0x{cmd:02X} failed: {STATUS_NAMES.get(status, status)}")
+        return status, data
+
+    def _forget(self, seq: int):
+        """Stop waiting for responses with a sequence number"""
+        with self._lock:
+            self._pending.pop(seq, None)
+            self._in_flight.pop(seq, None)
+            self._lock.notify_all()
+
+    def pipeline(self, requests, timeout: float = None) -> List[Tuple[int, bytes]]:
+        """Send several commands back to back and collect their responses in order
+
+        The frames overlap with the responses to the ones before, as far as the device receive buffer allows.
+
+        Args:
+            requests: Iterable of (command code, payload)
+            timeout: Timeout in seconds per response (default: the client timeout)
 
-        # Send empty line to finish
-        self.ser.write(b'\r\n')
+        Returns:
+            List of (status, data), one per request
+
+        Raises:
+            EEPROMProgrammerError: If the device reports an error other than a verify mismatch
+        """
+        seqs = []
+        try:
+            for cmd, payload in requests:
+                seqs.append(self.submit(cmd, payload, timeout))
+            return [self.result(seq, timeout) for seq in seqs]
+        finally:
+            for seq in seqs:
+                self._forget(seq)
+
+    def _transact(self, cmd: int, payload: bytes = b'', timeout: float = None) -> Tuple[int, bytes]:
+        """Send a command frame and wait for its response
+
+        Args:
+            cmd: Command code (CMD_*)
+            payload: Command payload
+            timeout: Timeout in seconds (default: the client timeout)
+
+        Returns:
+            Tuple of (status, data)
+
+        Raises:
+            EEPROMProgrammerError: If the device reports an error other than a verify mismatch
+        """
+        return self.result(self.submit(cmd, payload, timeout), timeout)
+
+    def status(self) -> Dict[str, int]:
+        """Query protocol version and chip geometry
+
+        Returns:
+            Dictionary with version, size, page_size, max_payload and sockets
+        """
+        _, data = self._transact(CMD_STATUS)
+        version, size, page_size, max_payload = struct.unpack('<BHBB', data[:5])
+        sockets = data[5] if len(data) > 5 else 1
+        self._page_size = page_size
+        self._max_payload = max_payload
+        self._sockets = sockets
+        return {'version': version, 'size': size, 'page_size': page_size, 'max_payload': max_payload,
+                'sockets': sockets}
+
+    def select_socket(self, socket: int):
+        """Select the socket read by read_range(), read_rle(), page_crcs() and crc32()
+
+        Writes always program every socket and verify_range() compares all of them.
+
+        Args:
+            socket: Socket number, 0 after reset
+        """
+        self._transact(CMD_SOCKET, bytes([socket]))
+
+    def set_baud(self, baudrate: int) -> bool:
+        """Switch both sides to a new baud rate and check it with a CRC-checked test frame
+
+        If the test frame fails, the device falls back to 115200 on its own and so does the client.
+        A late answer to the test frame has confirmed the new rate anyway, so that is checked as well.
+
+        Args:
+            baudrate: New baud rate, e.g. 500000, 1000000 or 2000000
+
+        Returns:
+            True if the new rate works, False if both sides are back at 115200
+        """
+        self._transact(CMD_BAUD, struct.pack('<I', baudrate))
+        self.ser.baudrate = baudrate
+        self._flush_input()
+        try:
+            self._transact(CMD_STATUS, timeout=BAUD_CONFIRM_TIME / 2)
+            return True
+        except EEPROMProgrammerError:
+            pass
+
+        # Wait until the device has fallen back. A late test frame may still have confirmed the new rate.
+        time.sleep(BAUD_CONFIRM_TIME)
+        for rate in (DEFAULT_BAUD, baudrate):
+            self.ser.baudrate = rate
+            self._flush_input()
+            try:
+                self._transact(CMD_STATUS, timeout=BAUD_CONFIRM_TIME)
+                return rate == baudrate
+            except EEPROMProgrammerError:
+                pass
+        raise EEPROMProgrammerError(f"No response at {DEFAULT_BAUD} or {baudrate} baud")
+
+    def read_range(self, start: int, length: int) -> bytes:
+        """Read an address range using binary frames
+
+        Args:
+            start: Start address
+            length: Number of bytes
+
+        Returns:
+            EEPROM contents
+        """
+        # Transfer time of a chunk at the current baud rate plus margin
+        timeout = 2.0 + READ_CHUNK_SIZE * 10 / self.ser.baudrate * 2
+        requests = [(CMD_READ, struct.pack('<HH', start + offset, min(length - offset, READ_CHUNK_SIZE)))
+                    for offset in range(0, length, READ_CHUNK_SIZE)]
+        return b''.join(block for _, block in self.pipeline(requests, timeout))
+
+    def read_rle(self, start: int, length: int) -> bytes:
+        """Read an address range run-length encoded, blank areas cost a few bytes on the serial line
+
+        Args:
+            start: Start address
+            length: Number of bytes
+
+        Returns:
+            EEPROM contents
+        """
+        data = bytearray()
+        while len(data) < length:
+            _, block = self._transact(CMD_READ_RLE, struct.pack('<HH', start + len(data), length - len(data)))
+            covered, = struct.unpack('<H', block[:2])
+            chunk = rle_decode(block[2:])
+            if covered == 0 or len(chunk) != covered:
+                raise EEPROMProgrammerError(f"Run-length response covers {covered} bytes, decoded {len(chunk)}")
+            data += chunk
+        return bytes(data)
+
+    def dump(self, start: int, length: int) -> bytes:
+        """Read an address range with one CMD_DUMP request, the programmer streams run-length encoded frames
+        back to back until the range is covered
+
+        Args:
+            start: Start address
+            length: Number of bytes
+
+        Returns:
+            EEPROM contents
+        """
+        seq = self.submit(CMD_DUMP, struct.pack('<HH', start, length))
+        data = bytearray()
+        try:
+            while True:
+                _, block = self.result(seq, more=True)
+                covered, = struct.unpack('<H', block[:2])
+                chunk = rle_decode(block[2:])
+                if len(chunk) != covered:
+                    raise EEPROMProgrammerError(f"Run-length response covers {covered} bytes, decoded {len(chunk)}")
+                data += chunk
+                if len(data) >= length:
+                    return bytes(data)
+        finally:
+            self._forget(seq)
+
+    def _page_chunks(self, start: int, data: bytes):
+        """Split data into chunks that do not cross an EEPROM page boundary
+
+        Yields:
+            Tuples of (address, chunk)
+        """
+        offset = 0
+        while offset < len(data):
+            address = start + offset
+            count = min(len(data) - offset, self._page_size - address % self._page_size)
+            yield address, data[offset:offset + count]
+            offset += count
+
+    def write_range(self, start: int, data: bytes):
+        """Write data page by page using binary frames, every page is verified by the device
+
+        Args:
+            start: Start address
+            data: Data to write
+
+        Raises:
+            EEPROMProgrammerError: If a page fails verification
+        """
+        requests = [(CMD_WRITE, struct.pack('<H', address) + chunk) for address, chunk in self._page_chunks(start, data)]
+        for status, result in self.pipeline(requests):
+            if status == STATUS_VERIFY_FAILED:
+                mismatches, first = struct.unpack('<HH', result)
+                raise EEPROMProgrammerError(f"Verification failed at 0x{first:04X} ({mismatches} bytes)")
+
+    def write_rle(self, start: int, data: bytes) -> int:
+        """Write data run-length encoded, the device decodes it into its page buffer and verifies every page
+
+        Frames hold whole pages, so no page is split into two write cycles. A page that does not compress into
+        one frame is sent with CMD_WRITE.
+
+        Args:
+            start: Start address
+            data: Data to write
+
+        Returns:
+            Number of encoded bytes sent
+
+        Raises:
+            EEPROMProgrammerError: If a page fails verification
+        """
+        limit = self._max_payload - 2
+        frames = []
+        pages = bytearray()
+        encoded = b''
+        frame_address = start
+        for address, chunk in self._page_chunks(start, data):
+            # Encode the pages of a frame in one pass, a run may carry on across a page boundary
+            joined = b''.join(token for token, _ in rle_tokens(bytes(pages + chunk)))
+            if len(joined) <= limit:
+                pages += chunk
+                encoded = joined
+                continue
+            if pages:
+                frames.append((CMD_WRITE_RLE, frame_address, encoded, len(pages)))
+            pages = bytearray(chunk)
+            encoded = b''.join(token for token, _ in rle_tokens(chunk))
+            frame_address = address
+            if len(encoded) > limit:
+                frames.append((CMD_WRITE, address, chunk, len(chunk)))
+                pages = bytearray()
+                encoded = b''
+                frame_address = address + len(chunk)
+        if pages:
+            frames.append((CMD_WRITE_RLE, frame_address, encoded, len(pages)))
+
+        requests = [(cmd, struct.pack('<H', address) + frame) for cmd, address, frame, _ in frames]
+        for (cmd, address, _, length), (status, result) in zip(frames, self.pipeline(requests)):
+            if status == STATUS_VERIFY_FAILED:
+                mismatches, first = struct.unpack('<HH', result[:4])
+                raise EEPROMProgrammerError(f"Verification failed at 0x{first:04X} ({mismatches} bytes)")
+            if cmd == CMD_WRITE_RLE and struct.unpack('<H', result[4:6])[0] != length:
+                decoded = struct.unpack('<H', result[4:6])[0]
+                raise EEPROMProgrammerError(f"Frame at 0x{address:04X} decoded to {decoded} bytes instead of {length}")
+        return sum(len(frame) for _, _, frame, _ in frames)
+
+    def verify_range(self, start: int, data: bytes) -> Tuple[int, int]:
+        """Compare an address range with data using binary frames
+
+        Args:
+            start: Start address
+            data: Expected data
+
+        Returns:
+            Tuple of (number of mismatching bytes, first mismatching address or -1)
+        """
+        total = 0
+        first_mismatch = -1
+        requests = [(CMD_VERIFY, struct.pack('<H', address) + chunk) for address, chunk in self._page_chunks(start, data)]
+        for status, result in self.pipeline(requests):
+            if status == STATUS_VERIFY_FAILED:
+                mismatches, first = struct.unpack('<HH', result)
+                total += mismatches
+                if first_mismatch < 0:
+                    first_mismatch = first
+        return total, first_mismatch
+
+    def page_crcs(self, start: int, length: int) -> List[int]:
+        """Read the CRC16 (CRC-16/CCITT-FALSE) of every page in an address range
+
+        Args:
+            start: Start address, must be page aligned
+            length: Number of bytes, the last page may be partial
+
+        Returns:
+            List of CRC values, one per page
+        """
+        # Roughly 0.2 ms per byte on the I2C bus plus margin
+        timeout = 2.0 + length * 0.0005
+        _, data = self._transact(CMD_PAGE_CRC, struct.pack('<HH', start, length), timeout)
+        return [crc for crc, in struct.iter_unpack('<H', data)]
+
+    def crc32(self, start: int, length: int) -> int:
+        """Compute the CRC32 of an address range on the device
+
+        Args:
+            start: Start address
+            length: Number of bytes
+
+        Returns:
+            CRC32 value, same as zlib.crc32() of the data
+        """
+        # Roughly 0.2 ms per byte on the I2C bus plus margin
+        timeout = 2.0 + length * 0.0005
+        _, data = self._transact(CMD_CRC32, struct.pack('<HH', start, length), timeout)
+        return struct.unpack('<I', data)[0]
+
+    def blank_check(self, start: int = 0, length: int = 0, full: bool = False) -> Tuple[int, int]:
+        """Check an address range of every socket for bytes other than 0xFF
+
+        Args:
+            start: Start address
+            length: Number of bytes (default: 0 = to the end of the EEPROM)
+            full: Scan the whole range, otherwise stop at the first block that is not blank
+
+        Returns:
+            Tuple of (blocks not blank, first address not 0xFF), (0, start + length) if the range is blank
+        """
+        if not length:
+            length = self.status()['size'] - start
+        # Roughly 0.2 ms per byte and socket on the I2C bus plus margin
+        timeout = 2.0 + length * 0.0005 * self._sockets
+        flags = BLANK_FULL if full else 0
+        _, data = self._transact(CMD_BLANK_CHECK, struct.pack('<HHB', start, length, flags), timeout)
+        return struct.unpack('<HH', data)
+
+    def verify_pages(self, pages: List[Tuple[int, bytes]]) -> List[Tuple[int, int, int]]:
+        """Compare pages with the EEPROM contents of every socket using one CRC32 per contiguous run of pages
+
+        Args:
+            pages: List of (page address, page bytes) sorted by address
+
+        Returns:
+            List of (start, length, socket) of the runs that do not match, empty if all match
+        """
+        runs = []
+        for address, data in pages:
+            if runs and runs[-1][0] + len(runs[-1][1]) == address:
+                runs[-1][1].extend(data)
+            else:
+                runs.append((address, bytearray(data)))
+
+        mismatches = []
+        sockets = self.status()['sockets']
+        for socket in range(sockets):
+            if sockets > 1:
+                self.select_socket(socket)
+            # Roughly 0.2 ms per byte on the I2C bus plus margin
+            timeout = 2.0 + max((len(data) for _, data in runs), default=0) * 0.0005
+            crcs = self.pipeline([(CMD_CRC32, struct.pack('<HH', start, len(data))) for start, data in runs], timeout)
+            mismatches += [(start, len(data), socket) for (start, data), (_, crc) in zip(runs, crcs)
+                           if struct.unpack('<I', crc)[0] != zlib.crc32(data)]
+        if sockets > 1:
+            self.select_socket(0)
+        return mismatches
+
+    def write_incremental(self, start: int, data: bytes) -> Tuple[int, int]:
+        """Write only the pages that differ from the EEPROM contents
+
+        The device sends a CRC table of the target range, pages with a matching CRC in every socket are skipped.
+        A partial first page is compared with a verify frame instead.
+
+        Args:
+            start: Start address
+            data: Data to write
+
+        Returns:
+            Tuple of (pages written, pages compared)
+        """
+        page_size = self._page_size
+        first = start - start % page_size
+        end = start + len(data)
+        tables = []
+        for socket in range(self._sockets):
+            if self._sockets > 1:
+                self.select_socket(socket)
+            tables.append(self.page_crcs(first, end - first))
+        if self._sockets > 1:
+            self.select_socket(0)
+        crcs = tables[0]
+
+        written = 0
+        for index in range(len(crcs)):
+            page = first + index * page_size
+            low = max(page, start)
+            chunk = data[low - start:min(page + page_size, end) - start]
+            if low == page:
+                expected = binascii.crc_hqx(chunk, 0xFFFF)
+                changed = any(table[index] != expected for table in tables)
+            else:
+                changed = self.verify_range(low, chunk)[0] != 0
+            if changed:
+                self.write_range(low, chunk)
+                written += 1
+        return written, len(crcs)
 
     def close(self):
-        """Close serial connection"""
+        """Stop the reader thread and close the serial connection"""
+        self._closing = True
+        self._reader.join(1.0)
         self.ser.close()
 
 
+def write_compressed(programmer: ArduinoClient, memory: Dict[int, int], fill: int = 0xFF) -> Tuple[int, int, int]:
+    """Write a memory map as run-length encoded pages
+
+    Args:
+        programmer: Connected programmer
+        memory: Dictionary of address to byte value
+        fill: Value of page bytes not set by the memory map
+
+    Returns:
+        Tuple of (pages, bytes in the pages, encoded bytes sent)
+    """
+    page_size = programmer.status()['page_size']
+    pages = coalesce_pages(memory, page_size, fill)
+    sent = 0
+    for start, image in join_pages(pages):
+        sent += programmer.write_rle(start, image)
+    return len(pages), sum(len(page) for _, page in pages), sent
+
+
+def write_changed_pages(programmer: ArduinoClient, memory: Dict[int, int], fill: int = 0xFF) -> Tuple[int, int]:
+    """Write a memory map as whole pages, only the pages that differ from the EEPROM contents
+
+    The pages are the same as those of write_compressed() and coalesce_pages(), so a verify of them checks
+    exactly what was written.
+
+    Args:
+        programmer: Connected programmer
+        memory: Dictionary of address to byte value
+        fill: Value of page bytes not set by the memory map
+
+    Returns:
+        Tuple of (pages written, pages compared)
+    """
+    page_size = programmer.status()['page_size']
+    written = compared = 0
+    for start, image in join_pages(coalesce_pages(memory, page_size, fill)):
+        segment_written, segment_compared = programmer.write_incremental(start, image)
+        written += segment_written
+        compared += segment_compared
+    return written, compared
+
+
+_log_lock = threading.Lock()
+
+
+def log_counters(path: str, port: str, counters: Dict[str, int], ok: bool):
+    """Append the counters of one chip to a log file, one JSON object per line
+
+    Args:
+        path: Log file
+        port: Serial port of the programmer
+        counters: Result of ArduinoClient.counters()
+        ok: Whether the operations on the chip succeeded
+    """
+    entry = {'time': time.strftime('%Y-%m-%dT%H:%M:%S'), 'port': port, 'ok': ok}
+    entry.update(counters)
+    with _log_lock, open(path, 'a') as f:
+        f.write(json.dumps(entry) + '\n')
+
+
+def gang_program(ports: List[str], memory: Dict[int, int], baud: int = DEFAULT_BAUD, speed: int = 0,
+                 fill: int = 0xFF, incremental: bool = False, log: str = None) -> List[Dict]:
+    """Program and verify the same memory map on several programmers at once, one worker thread per port
+
+    The binary protocol is used on every port: run-length encoded pages, or only the changed pages with incremental.
+
+    Args:
+        ports: Serial port names
+        memory: Dictionary of address to byte value
+        baud: Baud rate to connect with
+        speed: Baud rate to negotiate after connecting, 0 to keep baud
+        fill: Value of page bytes not set by the memory map
+        incremental: Program only the pages that differ from the EEPROM contents
+        log: File to append the counters of every programmer to, see log_counters()
+
+    Returns:
+        One dictionary per port with port, ok, message, seconds and bytes (bytes in the programmed pages)
+    """
+    def worker(port: str) -> Dict:
+        result = {'port': port, 'ok': False, 'message': '', 'seconds': 0.0, 'bytes': 0}
+        start_time = time.time()
+        programmer = None
+        try:
+            programmer = ArduinoClient(port, baud)
+            if speed and not programmer.set_baud(speed):
+                result['message'] = f"{speed} baud failed, "
+            if incremental:
+                written, pages = write_changed_pages(programmer, memory, fill)
+                result['bytes'] = pages * programmer.status()['page_size']
+                result['message'] += f"{written} of {pages} pages written"
+            else:
+                pages, size, sent = write_compressed(programmer, memory, fill)
+                result['bytes'] = size
+                result['message'] += f"{pages} pages, {size} bytes sent as {sent}"
+
+            mismatches = programmer.verify_pages(coalesce_pages(memory, programmer.status()['page_size'], fill))
+            if mismatches:
+                raise EEPROMProgrammerError(f"verify failed in {len(mismatches)} ranges")
+            result['ok'] = True
+        except Exception as e:
+            result['message'] += str(e)
+        finally:
+            if programmer is not None:
+                try:
+                    if log:
+                        log_counters(log, port, programmer.counters(), result['ok'])
+                    programmer.close()
+                except Exception:
+                    pass
+        result['seconds'] = time.time() - start_time
+        return result
+
+    with ThreadPoolExecutor(max_workers=max(len(ports), 1)) as pool:
+        return list(pool.map(worker, ports))
+
+
 if __name__ == "__main__":
     import argparse
 
     parser = argparse.ArgumentParser(description='AT28C EEPROM Programmer CLI')
     parser.add_argument('--port', help='Serial port (if not specified, will try to detect)')
-    parser.add_argument('--baud', type=int, default=115200, help='Baud rate')
+    parser.add_argument('--baud', type=int, default=DEFAULT_BAUD, help='Baud rate')
+    parser.add_argument('--gang', action='store_true',
+                        help='With --write: program and verify all detected ports, or the comma separated --port list, '
+                             'at once')
+    parser.add_argument('--speed', type=int,
+                        help='Negotiate a higher baud rate after connecting, e.g. 1000000 (falls back to 115200)')
     parser.add_argument('--list', action='store_true', help='List available Arduino ports')
-    parser.add_argument('--clean', action='store_true', help='Clean (erase) the entire EEPROM')
+    parser.add_argument('--clean', action='store_true',
+                        help='Clean (erase) the entire EEPROM, skipped if it is blank already')
+    parser.add_argument('--blank-check', action='store_true',
+                        help='Check whether the EEPROM is blank (all bytes 0xFF)')
     parser.add_argument('--read', action='store_true', help='Read EEPROM contents')
     parser.add_argument('--output', type=str, help='Output file path for read data')
     parser.add_argument('--format', choices=['hex', 'bin'], default='hex',
                         help='Output format: hex (Intel HEX) or bin (binary)')
-    parser.add_argument('--write', type=str, help='Path to Intel HEX file to upload')
+    parser.add_argument('--socket', type=int, default=0,
+                        help='With --read: socket to read on a multi-socket programmer (default: 0)')
+    parser.add_argument('--write', type=str, help='Path to Intel HEX or binary (.bin) file to upload')
+    parser.add_argument('--address', type=lambda x: int(x, 0), default=0,
+                        help='With --write: load address of a binary file (default: 0)')
+    parser.add_argument('--fill', type=lambda x: int(x, 16), default=0xFF,
+                        help='With --write: hex value for bytes of a page not set by the file (default: FF)')
+    parser.add_argument('--verify', type=str,
+                        help='Compare the EEPROM with an Intel HEX or binary (.bin) file using CRC32')
+    parser.add_argument('--bench', action='store_true',
+                        help='Benchmark the programmer layers and the serial transfer')
+    parser.add_argument('--stats', action='store_true',
+                        help='Print write cycle statistics after the other operations')
+    parser.add_argument('--log', type=str,
+                        help='Append the bus counters and time per operation of every chip to this file (JSON lines)')
+    parser.add_argument('--incremental', action='store_true',
+                        help='With --write: program only the pages that differ from the EEPROM contents')
+    parser.add_argument('--compress', action='store_true',
+                        help='With --write: send the pages run-length encoded, the device expands them')
     args = parser.parse_args()
 
     if args.list:
@@ -329,6 +1437,38 @@ if __name__ == "__main__":
                 print(f"   Manufacturer: {port_info['manufacturer']}")
         sys.exit(0)
 
+    if args.gang:
+        if not args.write:
+            print("Error: --gang needs --write")
+            sys.exit(1)
+        if args.port:
+            gang_ports = [port.strip() for port in args.port.split(',') if port.strip()]
+        else:
+            gang_ports = [port_info['port'] for port_info in find_arduino_ports()]
+        if not gang_ports:
+            print("Error: No Arduino devices found!")
+            sys.exit(1)
+        try:
+            memory = load_memory(args.write, args.address)
+        except FileNotFoundError:
+            print(f"Error: File not found: {args.write}")
+            sys.exit(1)
+
+        print(f"\nGang programming {args.write} on {len(gang_ports)} ports...")
+        gang_start = time.time()
+        results = gang_program(gang_ports, memory, args.baud, args.speed or 0, args.fill, args.incremental, args.log)
+        elapsed = time.time() - gang_start
+
+        print("\nResults:")
+        for result in results:
+            state = 'OK  ' if result['ok'] else 'FAIL'
+            print(f"  {result['port']:<16} {state} {result['seconds']:6.1f} s  {result['message']}")
+        good = [result for result in results if result['ok']]
+        total = sum(result['bytes'] for result in good)
+        print(f"{len(good)} of {len(results)} devices OK, {total} bytes in {elapsed:.1f} s, "
+              f"{total / elapsed:.0f} bytes/s aggregate")
+        sys.exit(0 if len(good) == len(results) else 1)
+
     arduino_port = args.port
     if not arduino_port:
         # Try to automatically find an Arduino port
@@ -361,12 +1501,38 @@ if __name__ == "__main__":
             print(f"Unexpected error initializing programmer: {str(e)}")
             sys.exit(1)
 
+        if args.speed:
+            try:
+                if programmer.set_baud(args.speed):
+                    print(f"Serial speed: {args.speed} baud")
+                else:
+                    print(f"Serial speed {args.speed} baud failed, using {DEFAULT_BAUD} baud")
+            except Exception as e:
+                print(f"Error changing serial speed: {str(e)}")
+                sys.exit(1)
+
         # Perform operations
+        if args.blank_check:
+            print("\nBlank check...")
+            try:
+                dirty, first = programmer.blank_check(full=True)
+                if dirty:
+                    print(f"Not blank: {dirty} blocks, first byte at 0x{first:04X}")
+                else:
+                    print("EEPROM is blank")
+            except Exception as e:
+                print(f"Error checking EEPROM: {str(e)}")
+                sys.exit(1)
+
         if args.clean:
             print("\nCleaning EEPROM...")
             try:
-                # Send erase command and display raw response
-                programmer.erase()
+                # A fresh chip needs no erase, the check stops at the first byte that is not 0xFF
+                if programmer.blank_check()[0] == 0:
+                    print("EEPROM is blank, erase skipped")
+                else:
+                    # Send erase command and display raw response
+                    programmer.erase()
             except Exception as e:
                 print(f"Error cleaning EEPROM: {str(e)}")
                 sys.exit(1)
@@ -374,26 +1540,27 @@ if __name__ == "__main__":
         if args.read:
             print("\nRead EEPROM data...")
             try:
-                data = programmer.read()
+                size = programmer.status()['size']
+                if args.socket:
+                    programmer.select_socket(args.socket)
+                data = programmer.dump(0, size)
                 # Save to file if output path specified
                 if args.output:
                     try:
                         if args.format == 'bin':
                             # Save as binary file
                             with open(args.output, 'wb') as f:
-                                for _, bytes_data in data:
-                                    f.write(bytes(bytes_data))
+                                f.write(data)
                             print(f"\nSaved binary data to {args.output}")
 
                         else:  # hex format
                             # Save as Intel HEX file
                             with open(args.output, 'w') as f:
-                                for addr, bytes_data in data:
-                                    # Write data in 16-byte chunks
-                                    for chunk_start in range(0, len(bytes_data), 16):
-                                        chunk = bytes_data[chunk_start:chunk_start + 16]
-                                        record = bytes_to_hex_record(addr + chunk_start, 0, chunk)
-                                        f.write(record + '\n')
+                                # Write data in 16-byte chunks
+                                for chunk_start in range(0, len(data), 16):
+                                    chunk = list(data[chunk_start:chunk_start + 16])
+                                    record = bytes_to_hex_record(chunk_start, 0, chunk)
+                                    f.write(record + '\n')
 
                                 # Write end-of-file record
                                 f.write(':00000001FF\n')
@@ -402,6 +1569,10 @@ if __name__ == "__main__":
                     except Exception as e:
                         print(f"Error saving file: {str(e)}")
                         sys.exit(1)
+                else:
+                    for chunk_start in range(0, len(data), 16):
+                        chunk = data[chunk_start:chunk_start + 16]
+                        print(f"{chunk_start:04X}: " + ' '.join(f"{b:02X}" for b in chunk))
 
             except Exception as e:
                 print(f"Error reading EEPROM: {str(e)}")
@@ -409,12 +1580,23 @@ if __name__ == "__main__":
 
         if args.write:
             try:
-                with open(args.write, 'r') as f:
-                    result = f.read()
-
-                print(f"\nUploading hex file: {args.write}")
-                programmer.write_hex(result)
-                print("Upload complete")
+                memory = load_memory(args.write, args.address)
+
+                if args.incremental:
+                    print(f"\nUploading changed pages of file: {args.write}")
+                    written, pages = write_changed_pages(programmer, memory, args.fill)
+                    print(f"Upload complete, {written} of {pages} pages written")
+                elif args.compress:
+                    print(f"\nUploading compressed file: {args.write}")
+                    pages, size, sent = write_compressed(programmer, memory, args.fill)
+                    print(f"Upload complete, {pages} pages, {size} bytes sent as {sent}")
+                else:
+                    print(f"\nUploading file: {args.write}")
+                    pages = coalesce_pages(memory, fill=args.fill)
+                    errors = programmer.write_hex(pages_to_hex(pages))
+                    if errors:
+                        raise EEPROMProgrammerError(f"{errors} lines failed")
+                    print(f"Upload complete, {len(pages)} pages")
             except FileNotFoundError:
                 print(f"Error: Hex file not found: {args.write}")
                 sys.exit(1)
@@ -422,8 +1604,57 @@ if __name__ == "__main__":
                 print(f"Error uploading hex file: {str(e)}")
                 sys.exit(1)
 
+        if args.verify:
+            try:
+                print(f"\nVerifying against file: {args.verify}")
+                pages = coalesce_pages(load_memory(args.verify, args.address), fill=args.fill)
+                mismatches = programmer.verify_pages(pages)
+                sockets = programmer.status()['sockets']
+                for start, length, socket in mismatches:
+                    where = f" in socket {socket}" if sockets > 1 else ""
+                    print(f"Mismatch in 0x{start:04X}-0x{start + length - 1:04X}{where}")
+                if mismatches:
+                    print("Verify FAILED")
+                    sys.exit(1)
+                print("Verify OK")
+            except FileNotFoundError:
+                print(f"Error: File not found: {args.verify}")
+                sys.exit(1)
+            except Exception as e:
+                print(f"Error verifying EEPROM: {str(e)}")
+                sys.exit(1)
+
+        if args.bench:
+            try:
+                print("\nDevice benchmark:")
+                print(programmer.bench())
+                print("\nHost benchmark:")
+                for name, seconds, length in programmer.bench_host():
+                    if length:
+                        print(f"{name}: {length} bytes in {seconds:.3f} s, {length / seconds:.0f} bytes/s")
+                    else:
+                        print(f"{name}: {seconds * 1000:.2f} ms")
+            except Exception as e:
+                print(f"Error running benchmark: {str(e)}")
+                sys.exit(1)
+
+        if args.stats:
+            try:
+                print("\nWrite cycle statistics:")
+                print(programmer.stats())
+            except Exception as e:
+                print(f"Error reading statistics: {str(e)}")
+                sys.exit(1)
+
     finally:
         if programmer is not None:
+            if args.log:
+                failure = sys.exc_info()[1]
+                ok = failure is None or (isinstance(failure, SystemExit) and not failure.code)
+                try:
+                    log_counters(args.log, arduino_port, programmer.counters(), ok)
+                except Exception as e:
+                    print(f"Error logging counters: {str(e)}")
             try:
                 programmer.close()
             except Exception as e:
@@ -0,0 +1,160 @@
+# MIT License
+#
+# Copyright (c) 2024 Tomas Vecera, tomas@vecera.dev
+#
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documentation files (the "Software"), to deal
+# in the Software without restriction, including without limitation the rights
+# to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+# copies of the Software, and to permit persons to whom the Software is
+# furnished to do so, subject to the following conditions:
+#  *
+# The above copyright notice and this permission notice shall be included in all
+# copies or substantial portions of the Software.
+#  *
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+# AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+# SOFTWARE.
+
+"""Pack ROM images into src/rom_images.h for the R command of the programmer
+
+Every image is run-length encoded like CMD_WRITE_RLE and stored in program memory together with its
+name, load address, size and CRC32. Run it again whenever an image changes, then rebuild the firmware:
+
+    python pack_roms.py "../roms/omen_alpha_monitor.hex=Omen Alpha v3 Monitor"
+"""
+
+import argparse
+import os
+import sys
+import zlib
+from typing import List, Tuple
+
+from eeprom_programmer import load_memory, memory_to_image, rle_tokens
+
+DEFAULT_OUTPUT = os.path.normpath(os.path.join(os.path.dirname(os.path.abspath(__file__)), '..', 'src', 'rom_images.h'))
+
+
+def c_bytes(data: bytes, indent: str = '\t', per_line: int = 12) -> str:
+    """Format bytes as the lines of a C array initializer
+
+    Args:
+        data: Bytes to format
+        indent: Prefix of every line
+        per_line: Bytes per line
+
+    Returns:
+        Initializer lines without the braces
+    """
+    lines = []
+    for i in range(0, len(data), per_line):
+        lines.append(indent + ', '.join(f"0x{b:02x}" for b in data[i:i + per_line]) + ',')
+    return '\n'.join(lines)
+
+
+def c_string(text: str) -> str:
+    """Quote text as a C string literal"""
+    return '"' + text.replace('\\', '\\\\').replace('"', '\\"') + '"'
+
+
+def pack_image(path: str, address: int) -> Tuple[int, bytes, bytes]:
+    """Load an image and run-length encode it
+
+    Args:
+        path: Intel HEX or binary (.bin) file
+        address: Load address of a binary file
+
+    Returns:
+        Tuple of (start address, decoded bytes, encoded bytes)
+    """
+    start, image = memory_to_image(load_memory(path, address))
+    if not image:
+        raise ValueError(f"{path} holds no data")
+    if start + len(image) > 0x10000:
+        raise ValueError(f"{path} does not fit a 64 KB address space")
+    return start, image, b''.join(token for token, _ in rle_tokens(image))
+
+
+def generate(images: List[Tuple[str, int, bytes, bytes]]) -> str:
+    """Generate the header with all images
+
+    Args:
+        images: List of (name, start address, decoded bytes, encoded bytes)
+
+    Returns:
+        Contents of rom_images.h
+    """
+    out = [
+        '// Generated by cli/pack_roms.py, do not edit. Included by rom.cpp only.',
+        '',
+        '#ifndef EEPROM_ROM_IMAGES_H',
+        '#define EEPROM_ROM_IMAGES_H',
+        '',
+        '#include "chip.h"',
+        '#include "rom.h"',
+        '',
+    ]
+    for i, (name, start, image, packed) in enumerate(images):
+        out += [
+            f"// {name}: {len(image)} bytes at 0x{start:04X}, {len(packed)} bytes encoded",
+            f"static constexpr char rom_name_{i}[] PROGMEM = {c_string(name)};",
+            f"static constexpr uint8_t rom_data_{i}[] PROGMEM = {{",
+            c_bytes(packed),
+            '};',
+            f'static_assert(0x{start:04X} + {len(image)} <= EEPROM_SIZE, {c_string(name + " does not fit the EEPROM")});',
+            '',
+        ]
+
+    out.append('static constexpr rom_image rom_images[] PROGMEM = {')
+    for i, (name, start, image, packed) in enumerate(images):
+        crc = zlib.crc32(image)
+        out.append(f"\t{{rom_name_{i}, rom_data_{i}, sizeof(rom_data_{i}), 0x{start:04X}, {len(image)}, 0x{crc:08X}UL}},")
+    out += ['};', '']
+    # Decoded at compile time, a hand-edited or stale header does not build
+    for i, (name, _, _, _) in enumerate(images):
+        out.append(f"static_assert(rom_check(rom_images[{i}]), "
+                   f"{c_string(name + ': size or CRC32 does not match the data, run cli/pack_roms.py')});")
+    out += [
+        '',
+        '#define ROM_IMAGES  (sizeof(rom_images) / sizeof(rom_images[0]))',
+        '',
+        '#endif //EEPROM_ROM_IMAGES_H',
+        '',
+    ]
+    return '\n'.join(out)
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Pack ROM images into the programmer firmware')
+    parser.add_argument('images', nargs='+', metavar='FILE[=NAME]',
+                        help='Intel HEX or binary (.bin) image, optionally with the name shown by the R command')
+    parser.add_argument('--address', type=lambda x: int(x, 0), default=0,
+                        help='Load address of binary images (default: 0)')
+    parser.add_argument('--output', default=DEFAULT_OUTPUT, help='Header to write (default: src/rom_images.h)')
+    args = parser.parse_args()
+
+    images = []
+    for spec in args.images:
+        path, _, name = spec.partition('=')
+        if not name:
+            name = os.path.splitext(os.path.basename(path))[0]
+        try:
+            start, image, packed = pack_image(path, args.address)
+        except (OSError, ValueError) as e:
+            print(f"Error: {e}")
+            sys.exit(1)
+        images.append((name, start, image, packed))
+        print(f"{name}: {len(image)} bytes at 0x{start:04X}, {len(packed)} bytes encoded, "
+              f"CRC32 0x{zlib.crc32(image):08X}")
+
+    with open(args.output, 'w') as f:
+        f.write(generate(images))
+    print(f"Wrote {args.output}, {sum(len(p) for _, _, _, p in images)} bytes of program memory")
+
+
+if __name__ == '__main__':
+    main()
@@ -22,95 +22,195 @@
  * SOFTWARE.
  */
 
-#include <Wire.h>
 #include "main.h"
 #include "at28c.h"
-#include "util.h"
-
-#define MCP23017_ADDRESS  0x20   // Default I2C address (A0-A2 grounded)
-#define MCP23017_IODIRA   0x00   // I/O direction register for port A
-#define MCP23017_IODIRB   0x01   // I/O direction register for port B
-#define MCP23017_GPIOA    0x12   // Port register for port A
-#define MCP23017_GPIOB    0x13   // Port register for port B
-#define MCP23017_PORTA    0
-#define MCP23017_PORTB    1
+#include "gpio.h"
+#include "bus.h"
+#include "crc.h"
+#include "stats.h"
 
 #define tAS               1   // tAS (Address Setup Time) = 10 ns minimum
 #define tWP               1   // tWP (Write Pulse Width) = 100 ns minimum, 1000 ns maximum
 #define tDH               1   // tDH (Data Hold Time) = 10 ns minimum
+#define tOE               1   // tOE (OE to Output Delay) = 70 ns maximum (tACC = 150 ns is covered by I2C time)
+#define tBLC          chip::byte_load_us               // tBLC (Byte Load Cycle Time) between two bytes of one page
+#define RDY_TIMEOUT   (tBLC + cycle_max)               // us to wait for RDY/BUSY before falling back to polling
+#define WRITE_TIMEOUT (2UL * cycle_max)                // us of polling before a write cycle is given up
+#define RDY_MISSES    3                                // Cycles in a row without an edge, then RDY/BUSY is not used
+
+// CE of the active socket, a constant with a single socket
+#define ce_pin(socket) (EEPROM_SOCKETS == 1 ? eeprom_ce_pins[0] : eeprom_ce_pins[socket])
+
+#define ce0() gpio_low(ce_pin(active))
+#define ce1() gpio_high(ce_pin(active))
+#define we0() gpio_low(WE_PIN)
+#define we1() gpio_high(WE_PIN)
+#define oe0() gpio_low(OE_PIN)
+#define oe1() gpio_high(OE_PIN)
+
+#ifdef BUS_DIRECT
+static_assert(EEPROM_SOCKETS == 1, "BUS_DIRECT drives a single socket");
+#else
+static_assert(EEPROM_SOCKETS <= MCP23017_DEVICES, "One MCP23017 per socket, up to 8 on the I2C bus");
+#endif
+
+#ifdef RDY_PIN
+static_assert(chip::has_ready_pin, "RDY/BUSY is not available on the " CHIP_NAME);
+#if !(defined(__AVR_ATmega328P__) || defined(__AVR_ATmega168__)) || RDY_PIN < 8 || RDY_PIN > 13
+#error "RDY_PIN needs a pin change interrupt pin, 8-13 on the ATmega328P"
+#endif
 
-#define ce0() digitalWrite(CE_PIN, LOW)
-#define ce1() digitalWrite(CE_PIN, HIGH)
-#define we0() digitalWrite(WE_PIN, LOW)
-#define we1() digitalWrite(WE_PIN, HIGH)
-#define oe0() digitalWrite(OE_PIN, LOW)
-#define oe1() digitalWrite(OE_PIN, HIGH)
+/**
+ * @brief Check at compile time whether a pin is one of the CE pins, from socket index on.
+ */
+static constexpr bool is_ce_pin(const uint8_t pin, const uint8_t index = 0) {
+	return index < EEPROM_SOCKETS && (eeprom_ce_pins[index] == pin || is_ce_pin(pin, index + 1));
+}
+
+static_assert(!is_ce_pin(RDY_PIN), "RDY_PIN is also a CE pin in SOCKET_CE_PINS");
+
+static volatile bool rdy_done = false;         // Set on the rising edge of RDY/BUSY at the end of a write cycle
+static volatile unsigned long rdy_time;       // micros() of that edge
+static uint8_t rdy_misses = 0;                 // Cycles in a row without an edge within RDY_TIMEOUT
+
+ISR(PCINT0_vect) {
+	if (gpio_read(RDY_PIN) && !rdy_done) {
+		rdy_time = micros();
+		rdy_done = true;
+	}
+}
+#endif
+
+static uint8_t selected = 0;   // Socket for reads, see eeprom_select()
+static uint8_t active = 0;     // Socket driven by CE and the bus functions
+
+// Last byte loaded into every socket by a write that has not been polled to completion yet
+static uint8_t write_pending = 0;   // Bit per socket
+static uint16_t pending_address[EEPROM_SOCKETS];
+static uint8_t pending_data[EEPROM_SOCKETS];
+static unsigned long pending_since; // Last byte loaded into any socket
+static unsigned long poll_since;    // Start of WRITE_TIMEOUT, pending_since or the fall back from RDY/BUSY
+static unsigned long cycle_max;     // us the cycle takes at most, tWC or tEC for a chip erase
+
+// Polling state of that write, see eeprom_write_done()
+static uint16_t poll_count = 0;     // Reads so far, 0 before the first poll
+static uint8_t poll_busy;           // Bit per socket still busy at the last read
+static bool poll_started;           // Busy at the first poll, so the cycle length is known
+static uint8_t poll_previous[EEPROM_SOCKETS];
 
 inline void set_address(uint16_t address) __attribute__((always_inline));
 
-inline void set_port_mode(uint8_t port, uint8_t mode) __attribute__((always_inline));
+inline void set_data_mode(uint8_t mode) __attribute__((always_inline));
 
 inline void write_data(uint8_t data) __attribute__((always_inline));
 
+inline void write_data_address(uint8_t data, uint8_t address_low) __attribute__((always_inline));
+
 inline uint8_t read_data() __attribute__((always_inline));
 
+inline uint8_t set_address_read_data(uint16_t address) __attribute__((always_inline));
+
+inline void activate(uint8_t socket) __attribute__((always_inline));
+
 /**
- * @brief Set the address for the EEPROM. This function sets the lower 8 bits (A0-A7) using MCP23017 PORTB.
- * The upper bits (A8-A12) are set using Arduino pins.
+ * @brief Drive a socket: its CE pin and its MCP23017.
+ * @param socket Socket number
+ */
+inline void activate(const uint8_t socket) {
+	if (EEPROM_SOCKETS == 1) return;
+	active = socket;
+	bus_select(socket);
+}
+
+/**
+ * @brief Set the address for the EEPROM. This function sets the lower 8 bits (A0-A7) on the bus.
+ * The upper bits (A8 and up) are set using Arduino pins.
  * @param address EEPROM address
  */
 inline void set_address(uint16_t address) {
-	Wire.beginTransmission(MCP23017_ADDRESS);
-	Wire.write(MCP23017_GPIOB);
-	Wire.write(address & 0xFF);
-	Wire.endTransmission();
+	bus_write_address(address & 0xFF);
 
 	// Set upper address bits using Arduino pins
-	digitalWrite(A8_PIN, (address >> 8) & 1);
-	digitalWrite(A9_PIN, (address >> 9) & 1);
-	digitalWrite(A10_PIN, (address >> 10) & 1);
-	digitalWrite(A11_PIN, (address >> 11) & 1);
-	digitalWrite(A12_PIN, (address >> 12) & 1);
-
-#if CHIP_TYPE == 256
-    digitalWrite(A13_PIN, (address >> 13) & 1);
-    digitalWrite(A14_PIN, (address >> 14) & 1);
-#endif
+	gpio_address_high(address);
 }
 
 /**
- * @brief Set the I/O direction for a given MCP23017 port.
- * @param port Port number (PORTA = 0 or PORTB = 1)
+ * @brief Set the I/O direction of the data bus.
  * @param mode INPUT or OUTPUT
  */
-inline void set_port_mode(const uint8_t port, const uint8_t mode) {
-	Wire.beginTransmission(MCP23017_ADDRESS);
-	Wire.write(port == 0 ? MCP23017_IODIRA : MCP23017_IODIRB);
-	Wire.write(mode == INPUT ? 0xFF : 0x00); // All pins INPUT or OUTPUT
-	Wire.endTransmission();
+inline void set_data_mode(const uint8_t mode) {
+	bus_data_mode(mode);
 }
 
 /**
- * @brief Write data to MCP23017 GPIOA register - PORTA.
+ * @brief Write data to the data bus.
  * @param data Data to write
  */
 inline void write_data(const uint8_t data) {
-	Wire.beginTransmission(MCP23017_ADDRESS);
-	Wire.write(MCP23017_GPIOA);
-	Wire.write(data & 0xFF);
-	Wire.endTransmission();
+	bus_write_data(data);
 }
 
 /**
- * @brief Read data from MCP23017 GPIOA register - PORTA.
+ * @brief Write data and the lower address bits, in one transaction on the MCP23017.
+ * @param data Data to write
+ * @param address_low Lower address bits (A0-A7)
+ */
+inline void write_data_address(const uint8_t data, const uint8_t address_low) {
+	bus_write_data_address(data, address_low);
+}
+
+/**
+ * @brief Read data from the data bus.
  * @return Byte containing all 8 pins
  */
 inline uint8_t read_data() {
-	Wire.beginTransmission(MCP23017_ADDRESS);
-	Wire.write(MCP23017_GPIOA); // Read from GPIOA register
-	Wire.endTransmission();
-	Wire.requestFrom(MCP23017_ADDRESS, 1);
-	return Wire.read(); // Returns the byte containing all 8 pins
+	return bus_read_data();
+}
+
+/**
+ * @brief Set the lower address bits (A0-A7) and read data back, in one transaction on the MCP23017. The upper
+ * bits are not changed, the caller has to keep them valid.
+ * @param address EEPROM address
+ * @return Byte containing all 8 pins
+ */
+inline uint8_t set_address_read_data(const uint16_t address) {
+	return bus_write_address_read(address & 0xFF);
+}
+
+/**
+ * @brief Read data with one OE pulse for all sockets with CE low, so every EEPROM sees a new read cycle. Needed for
+ * toggle bit polling.
+ * @param sockets Bit per socket to read
+ * @param data Byte containing all 8 pins, per socket
+ */
+static void read_data_strobe(const uint8_t sockets, uint8_t *data) {
+	count_poll();
+	oe0();
+	delayMicroseconds(tOE); // tOE: Output enable time
+	for (uint8_t socket = 0; socket < EEPROM_SOCKETS; socket++) {
+		if (!(sockets & _BV(socket))) continue;
+		activate(socket);
+		data[socket] = read_data();
+	}
+	oe1();
+}
+
+/**
+ * @brief Remember a byte loaded into the active socket, the write cycle starts tBLC after the last one.
+ * @param address EEPROM address of the byte
+ * @param data Data written to it
+ */
+static void write_started(const uint16_t address, const uint8_t data) {
+	write_pending |= _BV(active);
+	pending_address[active] = address;
+	pending_data[active] = data;
+	pending_since = micros();
+	poll_since = pending_since;
+	cycle_max = chip::write_cycle_us;
+#ifdef RDY_PIN
+	if (rdy_done) rdy_misses = 0; // The last cycle ended with an edge, also if it was polled
+	rdy_done = false;
+#endif
 }
 
 /**
@@ -119,8 +219,9 @@ inline uint8_t read_data() {
  * @param command Command to send
  */
 static void send_command(const uint16_t address, const uint8_t command) {
-	set_address(address);
-	write_data(command);
+	// Data and address in one transaction, the bytes of a sequence have to follow each other within tBLC
+	gpio_address_high(address);
+	write_data_address(command, address & 0xFF);
 	delayMicroseconds(tAS); // tAS: Address setup time
 	we0();
 	delayMicroseconds(tWP); // tWP: Write pulse width
@@ -129,52 +230,78 @@ static void send_command(const uint16_t address, const uint8_t command) {
 }
 
 /**
- * @brief Enable or disable EEPROM write protection. This function is not available on all AT28C EEPROMs.
+ * @brief Enable or disable EEPROM write protection in every socket. Does nothing on parts without software data
+ * protection.
  * @param enable Enable write protection
  */
 void eeprom_write_protect(const bool enable) {
+	if (!chip::has_sdp) return;
+	eeprom_wait_ready();
 	oe1();
 	we1();
-	ce0();
-	set_port_mode(MCP23017_PORTA, OUTPUT);
-
-#if CHIP_TYPE == 64
-	if (enable) {
-		// Enable Software Data Protection (SDP)
-		send_command(0x1555, 0xAA);
-		send_command(0x0AAA, 0x55);
-		send_command(0x1555, 0xA0);
-	} else {
-		// Disable Software Data Protection (SDP)
-		send_command(0x1555, 0xAA);
-		send_command(0x0AAA, 0x55);
-		send_command(0x1555, 0x80);
-		send_command(0x1555, 0xAA);
-		send_command(0x0AAA, 0x55);
-		send_command(0x1555, 0x20);
-	}
-#endif
 
-#if CHIP_TYPE == 256
-  if (enable) {
-    // Enable Software Data Protection (SDP)
-    send_command(0x5555, 0xAA);
-    send_command(0x2AAA, 0x55);
-    send_command(0x5555, 0xA0);
-  } else {
-    // Disable Software Data Protection (SDP)
-    send_command(0x5555, 0xAA);
-    send_command(0x2AAA, 0x55);
-    send_command(0x5555, 0x80);
-    send_command(0x5555, 0xAA);
-    send_command(0x2AAA, 0x55);
-    send_command(0x5555, 0x20);
-  }
-#endif
+	// Each socket gets the sequence in turn, the write cycles run at the same time
+	for (uint8_t socket = 0; socket < EEPROM_SOCKETS; socket++) {
+		activate(socket);
+		ce0();
+		set_data_mode(OUTPUT);
+
+		if (enable) {
+			// Enable Software Data Protection (SDP)
+			send_command(chip::sdp_address1, 0xAA);
+			send_command(chip::sdp_address2, 0x55);
+			send_command(chip::sdp_address1, 0xA0);
+		} else {
+			// Disable Software Data Protection (SDP)
+			send_command(chip::sdp_address1, 0xAA);
+			send_command(chip::sdp_address2, 0x55);
+			send_command(chip::sdp_address1, 0x80);
+			send_command(chip::sdp_address1, 0xAA);
+			send_command(chip::sdp_address2, 0x55);
+			send_command(chip::sdp_address1, 0x20);
+		}
+
+		ce1();
+		set_data_mode(INPUT);
+	}
 
 	delay(10);
-	ce1();
-	set_port_mode(MCP23017_PORTA, INPUT);
+	activate(selected);
+}
+
+/**
+ * @brief Start erasing every socket to 0xFF with the six byte software chip erase sequence, chip::chip_erase_ms
+ * (about 20 ms) instead of a write cycle per page. It returns right away, the erase is polled like a page write by
+ * eeprom_write_done() on I/O6.
+ * @return False if the part has no software chip erase, nothing is done then
+ */
+bool eeprom_chip_erase() {
+	if (!chip::has_chip_erase) return false;
+	eeprom_wait_ready();
+	oe1();
+	we1();
+
+	// Like eeprom_write_protect(), the sockets erase at the same time
+	for (uint8_t socket = 0; socket < EEPROM_SOCKETS; socket++) {
+		activate(socket);
+		ce0();
+		set_data_mode(OUTPUT);
+
+		send_command(chip::sdp_address1, 0xAA);
+		send_command(chip::sdp_address2, 0x55);
+		send_command(chip::sdp_address1, 0x80);
+		send_command(chip::sdp_address1, 0xAA);
+		send_command(chip::sdp_address2, 0x55);
+		send_command(chip::sdp_address1, 0x10);
+		write_started(chip::sdp_address1, 0xFF);
+
+		ce1();
+		set_data_mode(INPUT);
+	}
+
+	cycle_max = chip::chip_erase_ms * 1000UL;
+	activate(selected);
+	return true;
 }
 
 /**
@@ -182,92 +309,371 @@ void eeprom_write_protect(const bool enable) {
  * @return True if initialization was successful, false otherwise
  */
 bool eeprom_init() {
-	Wire.begin();
-
 	we1();
 	oe1();
-	ce1();
 	pinMode(WE_PIN, OUTPUT);
 	pinMode(OE_PIN, OUTPUT);
-	pinMode(CE_PIN, OUTPUT);
+	for (uint8_t socket = 0; socket < EEPROM_SOCKETS; socket++) {
+		gpio_high(ce_pin(socket));
+		pinMode(ce_pin(socket), OUTPUT);
+	}
 
 	pinMode(A8_PIN, OUTPUT);
 	pinMode(A9_PIN, OUTPUT);
 	pinMode(A10_PIN, OUTPUT);
-	pinMode(A11_PIN, OUTPUT);
-	pinMode(A12_PIN, OUTPUT);
-#if CHIP_TYPE == 256
-    pinMode(A13_PIN, OUTPUT);
-    pinMode(A14_PIN, OUTPUT);
+	if (ADDR_BITS > 11) {
+		pinMode(A11_PIN, OUTPUT);
+		pinMode(A12_PIN, OUTPUT);
+	}
+	if (ADDR_BITS > 13) {
+		pinMode(A13_PIN, OUTPUT);
+		pinMode(A14_PIN, OUTPUT);
+	}
+
+#ifdef RDY_PIN
+	// RDY/BUSY is open drain, enable the pin change interrupt for its rising edge
+	pinMode(RDY_PIN, INPUT_PULLUP);
+	PCMSK0 |= _BV(GPIO_BIT(RDY_PIN));
+	PCIFR = _BV(PCIF0);
+	PCICR |= _BV(PCIE0);
 #endif
 
-	// Configure MCP23017 ports
-	set_port_mode(MCP23017_PORTA, INPUT);
-	set_port_mode(MCP23017_PORTB, OUTPUT);
+	// Configure the bus of every socket - data INPUT, A0-A7 OUTPUT
+	return bus_init(EEPROM_SOCKETS);
+}
 
-	return true;
+/**
+ * @brief Select the socket for reads. Writes always go to every socket, verifies check every socket.
+ * @param socket Socket number, 0 to EEPROM_SOCKETS - 1
+ */
+void eeprom_select(const uint8_t socket) {
+	if (socket >= EEPROM_SOCKETS) return;
+	selected = socket;
+	activate(socket);
+}
+
+/**
+ * @brief Get the socket selected for reads.
+ * @return Socket number
+ */
+uint8_t eeprom_selected() {
+	return selected;
 }
 
 /**
- * @brief Write a byte to the EEPROM and use data polling to verify the write operation.
+ * @brief Get the number of bytes from an address up to the end of its page.
  * @param address EEPROM address
- * @param data Data to write
+ * @param len Number of bytes requested
+ * @return Number of bytes that fit into the page
  */
-void eeprom_write_byte(const uint16_t address, const uint8_t data) {
-	if (address >= EEPROM_SIZE) return;
+static uint8_t page_count(const uint16_t address, const uint16_t len) {
+	const uint8_t count = EEPROM_PAGE_SIZE - (address & (EEPROM_PAGE_SIZE - 1));
+	return len < count ? len : count;
+}
 
-	// Prepare for write
+/**
+ * @brief Read a block of bytes from the active socket, without waiting for a write cycle.
+ * @param start EEPROM address of the first byte
+ * @param buf Buffer for the data
+ * @param len Number of bytes to read
+ */
+static void read_block(const uint16_t start, uint8_t *buf, const uint16_t len) {
+	set_data_mode(INPUT);
 	oe1();
 	we1();
-	set_address(address);
-	set_port_mode(MCP23017_PORTA, OUTPUT);
-	write_data(data);
+	gpio_address_high(start);
+	ce0();
+	oe0();
+	delayMicroseconds(tOE); // tOE: Output enable time
+
+	for (uint16_t i = 0; i < len; i++) {
+		const uint16_t address = start + i;
+		// A8 and up change only on a 256 byte boundary
+		if ((address & 0xFF) == 0) gpio_address_high(address);
+		buf[i] = set_address_read_data(address);
+	}
+
+	oe1();
+	ce1();
+}
 
-	// Begin write cycle
+/**
+ * @brief Load bytes of one page into the active socket.
+ * @param address EEPROM address of the first byte
+ * @param buf Data to write
+ * @param count Number of bytes, must not cross the page boundary
+ * @param current Current EEPROM contents, bytes that already match are not loaded. Can be nullptr.
+ */
+static void socket_load(const uint16_t address, const uint8_t *buf, const uint8_t count, const uint8_t *current) {
+	set_data_mode(OUTPUT);
 	ce0();
-	delayMicroseconds(tAS); // Address setup time
-	we0();
-	delayMicroseconds(tWP); // Write pulse width
-	we1();
+
+	// Load the page, every byte has to follow the previous one within tBLC
+	for (uint8_t i = 0; i < count; i++) {
+		if (current != nullptr && current[i] == buf[i]) continue;
+
+		write_data_address(buf[i], (address + i) & 0xFF);
+		delayMicroseconds(tAS); // Address setup time
+		we0();
+		delayMicroseconds(tWP); // Write pulse width
+		we1();
+		write_started(address + i, buf[i]);
+	}
 	delayMicroseconds(tDH); // Data hold time
 	ce1();
 
-	// Switch to reading for data polling
-	set_port_mode(MCP23017_PORTA, INPUT);
+	// The write cycle starts after tBLC, leave the data port in input mode
+	set_data_mode(INPUT);
+}
+
+/**
+ * @brief Load bytes of one page into every socket and return without waiting, the EEPROMs run the write cycles on
+ * their own. The sockets are loaded one after the other, so their write cycles overlap.
+ * @param address EEPROM address of the first byte
+ * @param buf Data to write
+ * @param count Number of bytes, must not cross the page boundary
+ * @param current Current EEPROM contents of the selected socket, bytes that already match are not loaded. The other
+ * sockets are compared with their own contents. Can be nullptr.
+ * @return True if at least one byte was loaded and a write cycle started
+ */
+static bool page_load(const uint16_t address, const uint8_t *buf, const uint8_t count, const uint8_t *current) {
+	eeprom_wait_ready();
+
+	// Prepare for write, A8 and up are the same for the whole page
+	oe1();
 	we1();
-	ce0();
-	oe0();
+	gpio_address_high(address);
 
-	// Poll I/O7 until write completes
-	// During write, I/O7 outputs complement of written data
-	// Write is complete when I/O7 matches written data
-	const uint8_t expected_io7 = data & 0x80;
-	uint8_t current_io7;
+	for (uint8_t socket = 0; socket < EEPROM_SOCKETS; socket++) {
+		activate(socket);
 
-	do {
-		current_io7 = read_data() & 0x80;
-	} while (current_io7 != expected_io7);
+		// The sockets loaded before are busy, but their CE stays high while this one is read
+		const uint8_t *contents = current;
+		uint8_t buffer[EEPROM_PAGE_SIZE];
+		if (EEPROM_SOCKETS > 1 && current != nullptr && socket != selected) {
+			read_block(address, buffer, count);
+			contents = buffer;
+		}
 
-	oe1();
-	ce1();
+		socket_load(address, buf, count, contents);
+	}
+	activate(selected);
+
+	return write_pending != 0;
 }
 
 /**
- * @brief Read a byte from the EEPROM.
+ * @brief Write a byte to the EEPROM and wait until the write cycle completes.
+ * @param address EEPROM address
+ * @param data Data to write
+ */
+void eeprom_write_byte(const uint16_t address, const uint8_t data) {
+	if (address >= EEPROM_SIZE) return;
+
+	page_load(address, &data, 1, nullptr);
+	eeprom_wait_ready();
+}
+
+/**
+ * @brief Check two consecutive reads of the last byte loaded into a socket. With the toggle bit I/O6 stops toggling at
+ * the end of the write cycle, with DATA polling I/O7 reads back the true value of the data written.
+ * @param socket Socket number
+ * @param previous First read
+ * @param current Second read
+ * @return True if the write cycle is complete
+ */
+static bool write_complete(const uint8_t socket, const uint8_t previous, const uint8_t current) {
+	if (chip::has_toggle_bit) return !((previous ^ current) & 0x40);
+	return !((current ^ pending_data[socket]) & 0x80);
+}
+
+/**
+ * @brief Get the sockets whose write cycle is still running.
+ * @param sockets Bit per socket to check
+ * @param previous First read, per socket
+ * @param current Second read, per socket
+ * @return Bit per socket that is still busy
+ */
+static uint8_t write_busy(const uint8_t sockets, const uint8_t *previous, const uint8_t *current) {
+	uint8_t busy = 0;
+	for (uint8_t socket = 0; socket < EEPROM_SOCKETS; socket++) {
+		if ((sockets & _BV(socket)) && !write_complete(socket, previous[socket], current[socket])) busy |= _BV(socket);
+	}
+	return busy;
+}
+
+/**
+ * @brief Check once whether the page write started by eeprom_write_page_start() has completed in every socket,
+ * without waiting. With RDY_PIN the pin change interrupt flags the end of the write cycle, otherwise every call reads
+ * the EEPROMs once more with the toggle bit (I/O6), or DATA polling (I/O7) on parts without it. A cycle without an
+ * edge on RDY/BUSY within RDY_TIMEOUT is polled, after RDY_MISSES of them in a row all cycles are polled until one ends
+ * with an edge again. All sockets are polled together. A write cycle is given up after WRITE_TIMEOUT, then it counts
+ * as complete. The cycle is recorded in stats.h.
+ * @return True if no write cycle is running
+ */
+bool eeprom_write_done() {
+	if (write_pending == 0) return true;
+
+#ifdef RDY_PIN
+	// With several sockets the open drain RDY/BUSY outputs are tied together, the line rises when all are done
+	if (poll_count == 0 && rdy_misses < RDY_MISSES) {
+		if (rdy_done) {
+			rdy_misses = 0;
+			write_pending = 0;
+			stats_write_cycle(rdy_time - pending_since, 0);
+			return true;
+		}
+		if (micros() - pending_since <= RDY_TIMEOUT) return false;
+
+		// No edge, e.g. a write ignored under SDP: this cycle is polled with a whole WRITE_TIMEOUT. After RDY_MISSES
+		// in a row the pin counts as not connected and cycles are polled right away, until one ends with an edge again.
+		rdy_misses++;
+		poll_since = micros();
+	}
+#endif
+
+	// The write cycle starts tBLC after the last loaded byte, until then the EEPROM outputs plain data
+	if (micros() - pending_since < tBLC) return false;
+
+	// First poll: every socket addresses its own last byte, A8 and up are the same page in all of them. CE stays low
+	// until the cycle is over, every EEPROM access waits for it first.
+	if (poll_count == 0) {
+		oe1();
+		we1();
+		for (uint8_t socket = 0; socket < EEPROM_SOCKETS; socket++) {
+			if (!(write_pending & _BV(socket))) continue;
+			activate(socket);
+			set_data_mode(INPUT);
+			set_address(pending_address[socket]);
+			ce0();
+		}
+		poll_busy = write_pending;
+		read_data_strobe(poll_busy, poll_previous);
+		poll_count = 1;
+	}
+
+	// During write, I/O6 toggles on every read and I/O7 reads the complement of the data written. One OE pulse
+	// reads all sockets, only the busy ones are read again.
+	uint8_t current[EEPROM_SOCKETS];
+	read_data_strobe(poll_busy, current);
+	poll_count++;
+	const uint8_t busy = write_busy(poll_busy, poll_previous, current);
+	if (poll_count == 2) poll_started = busy != 0;
+
+	const bool timeout = micros() - poll_since > WRITE_TIMEOUT;
+	if (busy != 0 && !timeout) {
+		memcpy(poll_previous, current, sizeof(current));
+		poll_busy = busy;
+		activate(selected);
+		return false;
+	}
+
+	for (uint8_t socket = 0; socket < EEPROM_SOCKETS; socket++) {
+		if (!(write_pending & _BV(socket))) continue;
+		activate(socket);
+		ce1();
+	}
+	activate(selected);
+	write_pending = 0;
+
+	// A cycle that was over at the first poll has an unknown length
+	if (busy != 0) {
+		stats_write_timeout();
+	} else if (poll_started) {
+		stats_write_cycle(micros() - pending_since, poll_count);
+	} else {
+		stats_write_untimed();
+	}
+	poll_count = 0;
+	return true;
+}
+
+/**
+ * @brief Wait until the page write started by eeprom_write_page_start() completes in every socket, see
+ * eeprom_write_done(). Returns immediately if no write cycle is running, gives up after WRITE_TIMEOUT.
+ */
+void eeprom_wait_ready() {
+	while (!eeprom_write_done()) {}
+}
+
+/**
+ * @brief Write up to one page to the EEPROM in a single write cycle and wait until the write cycle completes.
+ * The data is truncated at the page boundary, call it again with the rest of the buffer to continue on the next page.
+ * @param address EEPROM address of the first byte
+ * @param buf Data to write
+ * @param len Number of bytes to write
+ * @return Number of bytes written
+ */
+uint8_t eeprom_write_page(const uint16_t address, const uint8_t *buf, const uint16_t len) {
+	if (address >= EEPROM_SIZE || len == 0) return 0;
+
+	const uint8_t count = page_count(address, len);
+	page_load(address, buf, count, nullptr);
+	eeprom_wait_ready();
+
+	return count;
+}
+
+/**
+ * @brief Start writing up to one page to the EEPROM and return while the write cycle is still running. Only the
+ * bytes that differ from current are loaded. The next EEPROM access waits for the write to complete, or call
+ * eeprom_wait_ready(). The data is truncated at the page boundary.
+ * @param address EEPROM address of the first byte
+ * @param buf Data to write
+ * @param len Number of bytes to write
+ * @param current Current EEPROM contents of the same bytes in the selected socket, can be nullptr to load all bytes.
+ * The other sockets are read for their own contents.
+ * @return Number of bytes processed
+ */
+uint8_t eeprom_write_page_start(const uint16_t address, const uint8_t *buf, const uint16_t len, const uint8_t *current) {
+	if (address >= EEPROM_SIZE || len == 0) return 0;
+
+	const uint8_t count = page_count(address, len);
+	page_load(address, buf, count, current);
+
+	return count;
+}
+
+/**
+ * @brief Write up to one page to the EEPROM, but only the bytes that differ from its current contents.
+ * Pages that already match are skipped without a write cycle. The data is truncated at the page boundary.
+ * @param address EEPROM address of the first byte
+ * @param buf Data to write
+ * @param len Number of bytes to write
+ * @param written Set to true if a write cycle was needed, can be nullptr
+ * @return Number of bytes processed
+ */
+uint8_t eeprom_update_page(const uint16_t address, const uint8_t *buf, const uint16_t len, bool *written) {
+	if (address >= EEPROM_SIZE || len == 0) return 0;
+
+	const uint8_t count = page_count(address, len);
+	uint8_t current[EEPROM_PAGE_SIZE];
+	eeprom_read_block(address, current, count);
+
+	const bool changed = page_load(address, buf, count, current);
+	eeprom_wait_ready();
+	if (written != nullptr) *written = changed;
+
+	return count;
+}
+
+/**
+ * @brief Read a byte from the EEPROM in the selected socket.
  * @param address EEPROM address
  * @return Data read from the EEPROM
  */
 uint8_t eeprom_read_byte(const uint16_t address) {
 	if (address >= EEPROM_SIZE) return 0xFF;
+	eeprom_wait_ready();
 
 	set_address(address);
-	set_port_mode(MCP23017_PORTA, INPUT);
+	set_data_mode(INPUT);
 	oe1();
 	we1();
 	ce0();
 	delayMicroseconds(tAS); // tAS: Address setup time
 	oe0();
-	delayMicroseconds(100); // tOE: Output enable time
+	delayMicroseconds(tOE); // tOE: Output enable time
 	const uint8_t data = read_data();
 	oe1();
 	ce1();
@@ -276,46 +682,148 @@ uint8_t eeprom_read_byte(const uint16_t address) {
 }
 
 /**
- * @brief Verify a byte in the EEPROM against an expected value.
+ * @brief Read a block of bytes from the EEPROM in the selected socket. Output enable stays active for the whole block and only the
+ * address bits that change between bytes are updated.
+ * @param start EEPROM address of the first byte
+ * @param buf Buffer for the data
+ * @param len Number of bytes to read
+ */
+void eeprom_read_block(const uint16_t start, uint8_t *buf, uint16_t len) {
+	if (start >= EEPROM_SIZE) return;
+	if (len > EEPROM_SIZE - start) len = EEPROM_SIZE - start;
+	eeprom_wait_ready();
+
+	read_block(start, buf, len);
+}
+
+/**
+ * @brief Print a verification failure.
+ * @param socket Socket number, only printed with several sockets
  * @param address EEPROM address
  * @param expected Expected data
- * @return True if the data matches, false otherwise
+ * @param read_back Data read from the EEPROM
  */
-bool eeprom_verify_byte(const uint16_t address, const uint8_t expected) {
-	const uint8_t read_back = eeprom_read_byte(address);
-
-	if (read_back != expected) {
-		Serial.print(F("\nVerification failed at 0x"));
-		Serial.print(address, HEX);
-		Serial.print(F(": Expected 0x"));
-		Serial.print(expected, HEX);
-		Serial.print(F(", Read 0x"));
-		Serial.println(read_back, HEX);
-		return false;
+static void print_mismatch(const uint8_t socket, const uint16_t address, const uint8_t expected,
+                           const uint8_t read_back) {
+	Serial.print(F("\nVerification failed at 0x"));
+	Serial.print(address, HEX);
+	if (EEPROM_SOCKETS > 1) {
+		Serial.print(F(" in socket "));
+		Serial.print(socket);
 	}
+	Serial.print(F(": Expected 0x"));
+	Serial.print(expected, HEX);
+	Serial.print(F(", Read 0x"));
+	Serial.println(read_back, HEX);
+}
 
-	return true;
+/**
+ * @brief Compute the CRC32 of a block of the EEPROM in the selected socket, see crc32_update().
+ * @param start EEPROM address of the first byte
+ * @param len Number of bytes
+ * @return CRC32 of the bytes, same as zlib.crc32 on the host
+ */
+uint32_t eeprom_crc32(const uint16_t start, const uint16_t len) {
+	uint32_t crc = CRC32_INIT;
+	uint8_t buf[EEPROM_BLOCK_SIZE];
+	for (uint16_t offset = 0; offset < len; offset += sizeof(buf)) {
+		const uint16_t chunk = min(len - offset, sizeof(buf));
+		eeprom_read_block(start + offset, buf, chunk);
+		for (uint16_t i = 0; i < chunk; i++) {
+			crc = crc32_update(crc, buf[i]);
+		}
+	}
+	return ~crc;
+}
+
+/**
+ * @brief Verify a byte in the EEPROM of every socket against an expected value.
+ * @param address EEPROM address
+ * @param expected Expected data
+ * @return True if the data matches in every socket, false otherwise
+ */
+bool eeprom_verify_byte(const uint16_t address, const uint8_t expected) {
+	return eeprom_verify_block(address, &expected, 1) == 0;
 }
 
 /**
- * @brief Erase a section of the EEPROM by writing a pattern to all bytes.
- * @param start Start address
- * @param end End address
- * @param pattern Pattern to write
+ * @brief Verify a block of bytes in the EEPROM of every socket against expected values.
+ * @param start EEPROM address of the first byte
+ * @param expected Expected data
+ * @param len Number of bytes to verify
+ * @return Number of bytes that do not match, summed over all sockets
  */
-void eeprom_erase_section(const uint16_t start, const uint16_t end, const uint8_t pattern) {
-	Serial.print(F("Erasing EEPROM from 0x"));
-	Serial.print(start, HEX);
-	Serial.print(F(" to 0x"));
-	Serial.print(end - 1, HEX);
-	Serial.print(F(" with pattern 0x"));
-	Serial.println(pattern, HEX);
+uint16_t eeprom_verify_block(const uint16_t start, const uint8_t *expected, uint16_t len) {
+	if (start >= EEPROM_SIZE) return 0;
+	if (len > EEPROM_SIZE - start) len = EEPROM_SIZE - start;
+	eeprom_wait_ready();
+
+	uint8_t buf[EEPROM_BLOCK_SIZE];
+	uint16_t errors = 0;
+
+	for (uint8_t socket = 0; socket < EEPROM_SOCKETS; socket++) {
+		activate(socket);
+		for (uint16_t offset = 0; offset < len; offset += sizeof(buf)) {
+			const uint16_t count = min(len - offset, sizeof(buf));
+			read_block(start + offset, buf, count);
+
+			for (uint16_t i = 0; i < count; i++) {
+				if (buf[i] == expected[offset + i]) continue;
+
+				print_mismatch(socket, start + offset + i, expected[offset + i], buf[i]);
+				errors++;
+			}
+		}
+	}
+	activate(selected);
 
-	for (uint16_t addr = start; addr < end; addr++) {
-		eeprom_write_byte(addr, pattern);
+	return errors;
+}
 
-		print_progress(addr);
+/**
+ * @brief Check that a range of the EEPROM is blank (all bytes 0xFF) in every socket. The range is read in blocks of
+ * EEPROM_BLOCK_SIZE aligned bytes, a page on parts with page mode.
+ * @param start EEPROM address of the first byte
+ * @param len Number of bytes to check
+ * @param full Scan the whole range, otherwise stop at the first block that is not blank
+ * @param first Set to the lowest address that is not 0xFF in any socket, start + len if the range is blank
+ * @return Number of blocks that are not blank in at least one socket, at most 1 without full
+ */
+uint16_t eeprom_blank_check(const uint16_t start, uint16_t len, const bool full, uint16_t *first) {
+	*first = start;
+	if (start >= EEPROM_SIZE) return 0;
+	if (len > EEPROM_SIZE - start) len = EEPROM_SIZE - start;
+	*first = start + len;
+	eeprom_wait_ready();
+
+	uint8_t buf[EEPROM_BLOCK_SIZE];
+	uint16_t dirty = 0;
+
+	for (uint16_t offset = 0; offset < len;) {
+		const uint16_t address = start + offset;
+		const uint16_t count = min(len - offset, sizeof(buf) - (address & (sizeof(buf) - 1)));
+
+		// Every socket is read, the first address is the lowest of all of them
+		bool blank = true;
+		for (uint8_t socket = 0; socket < EEPROM_SOCKETS; socket++) {
+			activate(socket);
+			read_block(address, buf, count);
+			for (uint16_t i = 0; i < count; i++) {
+				if (buf[i] == 0xFF) continue;
+
+				if (address + i < *first) *first = address + i;
+				blank = false;
+				break;
+			}
+		}
+		offset += count;
+
+		if (blank) continue;
+		dirty++;
+		if (!full) break;
 	}
+	activate(selected);
 
-	Serial.println(F("\nErase Done!"));
+	return dirty;
 }
+
@@ -25,16 +25,17 @@
 #ifndef EEPROM_AT28C_H
 #define EEPROM_AT28C_H
 
-#define EEPROM_SIZE  8192  // 8KB for AT28C64
-#define ADDR_BITS    13    // A0-A12
-#define CHIP_NAME    "AT28C64"
-
-#if CHIP_TYPE == 256
-#define EEPROM_SIZE  32768 // 32KB for AT28C256
-#define ADDR_BITS    15    // A0-A14
-#define CHIP_NAME    "AT28C256"
+#include "chip.h"
+
+#ifndef SOCKET_CE_PINS
+#define SOCKET_CE_PINS  CE_PIN
 #endif
 
+// CE pin of every socket, see SOCKET_CE_PINS in main.h
+constexpr uint8_t eeprom_ce_pins[] = {SOCKET_CE_PINS};
+
+#define EEPROM_SOCKETS  (sizeof(eeprom_ce_pins))
+
 /**
  * @brief Initialize the EEPROM programmer. This function must be called before any other EEPROM functions.
  * @return True if initialization was successful, false otherwise
@@ -42,40 +43,140 @@
 bool eeprom_init();
 
 /**
- * @brief Write a byte to the EEPROM and use data polling to verify the write operation.
+ * @brief Select the socket for reads. Writes always go to every socket, verifies check every socket.
+ * @param socket Socket number, 0 to EEPROM_SOCKETS - 1
+ */
+void eeprom_select(uint8_t socket);
+
+/**
+ * @brief Get the socket selected for reads.
+ * @return Socket number
+ */
+uint8_t eeprom_selected();
+
+/**
+ * @brief Write a byte to the EEPROM and wait until the write cycle completes.
  * @param address EEPROM address
  * @param data Data to write
  */
 void eeprom_write_byte(uint16_t address, uint8_t data);
 
 /**
- * @brief Read a byte from the EEPROM.
+ * @brief Write up to one page to the EEPROM in a single write cycle and wait until the write cycle completes.
+ * The data is truncated at the page boundary, call it again with the rest of the buffer to continue on the next page.
+ * @param address EEPROM address of the first byte
+ * @param buf Data to write
+ * @param len Number of bytes to write
+ * @return Number of bytes written
+ */
+uint8_t eeprom_write_page(uint16_t address, const uint8_t *buf, uint16_t len);
+
+/**
+ * @brief Start writing up to one page to the EEPROM and return while the write cycle is still running. Only the
+ * bytes that differ from current are loaded. The next EEPROM access waits for the write to complete, or call
+ * eeprom_wait_ready(). The data is truncated at the page boundary.
+ * @param address EEPROM address of the first byte
+ * @param buf Data to write
+ * @param len Number of bytes to write
+ * @param current Current EEPROM contents of the same bytes in the selected socket, can be nullptr to load all bytes.
+ * The other sockets are read for their own contents.
+ * @return Number of bytes processed
+ */
+uint8_t eeprom_write_page_start(uint16_t address, const uint8_t *buf, uint16_t len, const uint8_t *current);
+
+/**
+ * @brief Check once whether the page write started by eeprom_write_page_start() has completed in every socket,
+ * without waiting. With RDY_PIN the pin change interrupt flags the end of the write cycle, otherwise every call reads
+ * the EEPROMs once more with the toggle bit (I/O6), or DATA polling (I/O7) on parts without it. A cycle without an
+ * edge on RDY/BUSY within RDY_TIMEOUT is polled, after RDY_MISSES of them in a row all cycles are polled until one ends
+ * with an edge again. All sockets are polled together. A write cycle is given up after WRITE_TIMEOUT, then it counts
+ * as complete. The cycle is recorded in stats.h.
+ * @return True if no write cycle is running
+ */
+bool eeprom_write_done();
+
+/**
+ * @brief Wait until the page write started by eeprom_write_page_start() completes in every socket, see
+ * eeprom_write_done(). Returns immediately if no write cycle is running, gives up after WRITE_TIMEOUT.
+ */
+void eeprom_wait_ready();
+
+/**
+ * @brief Write up to one page to the EEPROM, but only the bytes that differ from its current contents.
+ * Pages that already match are skipped without a write cycle. The data is truncated at the page boundary.
+ * @param address EEPROM address of the first byte
+ * @param buf Data to write
+ * @param len Number of bytes to write
+ * @param written Set to true if a write cycle was needed, can be nullptr
+ * @return Number of bytes processed
+ */
+uint8_t eeprom_update_page(uint16_t address, const uint8_t *buf, uint16_t len, bool *written);
+
+/**
+ * @brief Read a byte from the EEPROM in the selected socket.
  * @param address EEPROM address
  * @return Data read from the EEPROM
  */
 uint8_t eeprom_read_byte(uint16_t address);
 
 /**
- * @brief Verify a byte in the EEPROM against an expected value.
+ * @brief Read a block of bytes from the EEPROM in the selected socket. Output enable stays active for the whole block and only the
+ * address bits that change between bytes are updated.
+ * @param start EEPROM address of the first byte
+ * @param buf Buffer for the data
+ * @param len Number of bytes to read
+ */
+void eeprom_read_block(uint16_t start, uint8_t *buf, uint16_t len);
+
+/**
+ * @brief Compute the CRC32 of a block of the EEPROM in the selected socket, see crc32_update().
+ * @param start EEPROM address of the first byte
+ * @param len Number of bytes
+ * @return CRC32 of the bytes, same as zlib.crc32 on the host
+ */
+uint32_t eeprom_crc32(uint16_t start, uint16_t len);
+
+/**
+ * @brief Verify a byte in the EEPROM of every socket against an expected value.
  * @param address EEPROM address
  * @param expected Expected data
- * @return True if the data matches, false otherwise
+ * @return True if the data matches in every socket, false otherwise
  */
 bool eeprom_verify_byte(uint16_t address, uint8_t expected);
 
 /**
- * @brief Enable or disable EEPROM write protection. This function is not available on all AT28C EEPROMs.
+ * @brief Verify a block of bytes in the EEPROM of every socket against expected values.
+ * @param start EEPROM address of the first byte
+ * @param expected Expected data
+ * @param len Number of bytes to verify
+ * @return Number of bytes that do not match, summed over all sockets
+ */
+uint16_t eeprom_verify_block(uint16_t start, const uint8_t *expected, uint16_t len);
+
+/**
+ * @brief Check that a range of the EEPROM is blank (all bytes 0xFF) in every socket. The range is read in blocks of
+ * EEPROM_BLOCK_SIZE aligned bytes, a page on parts with page mode.
+ * @param start EEPROM address of the first byte
+ * @param len Number of bytes to check
+ * @param full Scan the whole range, otherwise stop at the first block that is not blank
+ * @param first Set to the lowest address that is not 0xFF in any socket, start + len if the range is blank
+ * @return Number of blocks that are not blank in at least one socket, at most 1 without full
+ */
+uint16_t eeprom_blank_check(uint16_t start, uint16_t len, bool full, uint16_t *first);
+
+/**
+ * @brief Enable or disable EEPROM write protection in every socket. Does nothing on parts without software data
+ * protection.
  * @param enable Enable write protection
  */
 void eeprom_write_protect(bool enable);
 
-
 /**
- * @brief Erase a section of the EEPROM by writing a pattern to all bytes.
- * @param start Start address
- * @param end End address
- * @param pattern Pattern to write
+ * @brief Start erasing every socket to 0xFF with the six byte software chip erase sequence, chip::chip_erase_ms
+ * (about 20 ms) instead of a write cycle per page. It returns right away, the erase is polled like a page write by
+ * eeprom_write_done() on I/O6.
+ * @return False if the part has no software chip erase, nothing is done then
  */
-void eeprom_erase_section(uint16_t start, uint16_t end, uint8_t pattern);
+bool eeprom_chip_erase();
 
 #endif //EEPROM_AT28C_H
@@ -0,0 +1,128 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Tomas Vecera, tomas@vecera.dev
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "main.h"
+#include "at28c.h"
+#include "bench.h"
+#include "bus.h"
+#include "util.h"
+
+#define BENCH_ADDRESS      0x0000   // First byte of the benchmarked area
+#define BENCH_OPS          256      // Iterations of the single byte bus operations
+#define BENCH_BLOCK        1024     // Bytes for block read and verify
+#define BENCH_BYTE_WRITES  16       // Byte writes, every one takes a full write cycle
+#define BENCH_PAGES        4        // Page writes
+
+/**
+ * @brief Print one benchmark result.
+ * @param name Name of the benchmark
+ * @param us Elapsed time in microseconds
+ * @param ops Number of operations
+ * @param bytes Number of bytes transferred, 0 for operations without data
+ */
+static void bench_report(const __FlashStringHelper *name, const unsigned long us, const uint16_t ops,
+                         const uint16_t bytes) {
+	Serial.print(name);
+	Serial.print(F(": "));
+	Serial.print(ops);
+	Serial.print(F(" ops, "));
+	Serial.print(us / ops);
+	Serial.print(F(" us/op"));
+	if (bytes != 0 && us != 0) {
+		Serial.print(F(", "));
+		Serial.print(static_cast<uint32_t>(bytes) * 1000000UL / us);
+		Serial.print(F(" bytes/s"));
+	}
+	Serial.println();
+}
+
+/**
+ * @brief Benchmark every layer of the programmer and print us/op and bytes/s for each:
+ * - Address set (A0-A7 write on the bus)
+ * - Byte read
+ * - Block read
+ * - Byte write
+ * - Page write
+ * - Block verify
+ *
+ * The writes store the data that is already in the EEPROM, so the contents are not changed. With write
+ * protection enabled the EEPROM ignores them and the write results are meaningless. Writes load every socket and
+ * verifies compare every socket with the data read from the selected one, so both are skipped with several sockets
+ * (SOCKET_CE_PINS), where the other sockets may hold different data.
+ */
+void eeprom_bench() {
+	Serial.println(F("Benchmark"));
+	uint8_t buf[EEPROM_BLOCK_SIZE];
+	unsigned long start;
+
+	// Every value differs from the previous one, so the MCP23017 register cache does not skip the write
+	start = micros();
+	for (uint16_t i = 0; i < BENCH_OPS; i++) {
+		bus_write_address(i);
+	}
+	bench_report(F("Address set"), micros() - start, BENCH_OPS, 0);
+
+	start = micros();
+	for (uint16_t i = 0; i < BENCH_OPS; i++) {
+		buf[i % sizeof(buf)] = eeprom_read_byte(BENCH_ADDRESS + i);
+	}
+	bench_report(F("Byte read"), micros() - start, BENCH_OPS, BENCH_OPS);
+
+	start = micros();
+	for (uint16_t offset = 0; offset < BENCH_BLOCK; offset += sizeof(buf)) {
+		eeprom_read_block(BENCH_ADDRESS + offset, buf, sizeof(buf));
+	}
+	bench_report(F("Block read"), micros() - start, BENCH_BLOCK / sizeof(buf), BENCH_BLOCK);
+
+	unsigned long elapsed = 0;
+	if (EEPROM_SOCKETS == 1) {
+		eeprom_read_block(BENCH_ADDRESS, buf, BENCH_BYTE_WRITES);
+		start = micros();
+		for (uint8_t i = 0; i < BENCH_BYTE_WRITES; i++) {
+			eeprom_write_byte(BENCH_ADDRESS + i, buf[i]);
+		}
+		bench_report(F("Byte write"), micros() - start, BENCH_BYTE_WRITES, BENCH_BYTE_WRITES);
+
+		for (uint8_t page = 0; page < BENCH_PAGES; page++) {
+			const uint16_t address = BENCH_ADDRESS + page * EEPROM_PAGE_SIZE;
+			eeprom_read_block(address, buf, EEPROM_PAGE_SIZE);
+			start = micros();
+			eeprom_write_page(address, buf, EEPROM_PAGE_SIZE);
+			elapsed += micros() - start;
+		}
+		bench_report(F("Page write"), elapsed, BENCH_PAGES, BENCH_PAGES * EEPROM_PAGE_SIZE);
+
+		// Verify against the data just read, compares all bytes without printing mismatches
+		elapsed = 0;
+		for (uint16_t offset = 0; offset < BENCH_BLOCK; offset += sizeof(buf)) {
+			eeprom_read_block(BENCH_ADDRESS + offset, buf, sizeof(buf));
+			start = micros();
+			eeprom_verify_block(BENCH_ADDRESS + offset, buf, sizeof(buf));
+			elapsed += micros() - start;
+		}
+		bench_report(F("Verify"), elapsed, BENCH_BLOCK / sizeof(buf), BENCH_BLOCK);
+	} else {
+		Serial.println(F("Write and verify skipped: they use the data of the selected socket for all of them"));
+	}
+}
@@ -0,0 +1,44 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Tomas Vecera, tomas@vecera.dev
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef EEPROM_BENCH_H
+#define EEPROM_BENCH_H
+
+/**
+ * @brief Benchmark every layer of the programmer and print us/op and bytes/s for each:
+ * - Address set (A0-A7 write on the bus)
+ * - Byte read
+ * - Block read
+ * - Byte write
+ * - Page write
+ * - Block verify
+ *
+ * The writes store the data that is already in the EEPROM, so the contents are not changed. With write
+ * protection enabled the EEPROM ignores them and the write results are meaningless. Writes load every socket and
+ * verifies compare every socket with the data read from the selected one, so both are skipped with several sockets
+ * (SOCKET_CE_PINS), where the other sockets may hold different data.
+ */
+void eeprom_bench();
+
+#endif //EEPROM_BENCH_H
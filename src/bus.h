@@ -0,0 +1,183 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Tomas Vecera, tomas@vecera.dev
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef EEPROM_BUS_H
+#define EEPROM_BUS_H
+
+#include "main.h"
+
+/*
+ * Backend for the data bus (D0-D7) and the lower address bits (A0-A7), selected at compile time:
+ * - MCP23017 (default): PORTA drives D0-D7 and PORTB drives A0-A7, every access is an I2C transaction
+ * - BUS_DIRECT: two AVR ports are driven directly, for boards with enough pins (Arduino Mega)
+ *
+ * Every backend provides the same inline functions, so the EEPROM code does not depend on the one selected. With
+ * several sockets (SOCKET_CE_PINS) every socket has its own MCP23017, bus_select() picks the one driven.
+ */
+
+#ifdef BUS_DIRECT
+
+#if !(defined(__AVR_ATmega2560__) || defined(__AVR_ATmega1280__))
+#error "BUS_DIRECT needs two free 8-bit ports, PORTA and PORTC of the ATmega1280/2560"
+#endif
+
+#define BUS_DATA_PORT   PORTA   // D0-D7 on Mega pins 22-29
+#define BUS_DATA_PIN    PINA
+#define BUS_DATA_DDR    DDRA
+#define BUS_ADDR_PORT   PORTC   // A0-A7 on Mega pins 37-30
+#define BUS_ADDR_DDR    DDRC
+
+// tACC (Address to Output Delay) = 150 ns maximum, plus one cycle of the input synchronizer
+#define BUS_ACC_CYCLES  (F_CPU / 1000000UL * 150 / 1000 + 1)
+
+#else
+
+#include "mcp23017.h"
+
+#endif
+
+inline bool bus_init(uint8_t sockets) __attribute__((always_inline));
+
+inline void bus_select(uint8_t socket) __attribute__((always_inline));
+
+inline void bus_data_mode(uint8_t mode) __attribute__((always_inline));
+
+inline void bus_write_data(uint8_t data) __attribute__((always_inline));
+
+inline void bus_write_address(uint8_t address_low) __attribute__((always_inline));
+
+inline void bus_write_data_address(uint8_t data, uint8_t address_low) __attribute__((always_inline));
+
+inline uint8_t bus_read_data() __attribute__((always_inline));
+
+inline uint8_t bus_write_address_read(uint8_t address_low) __attribute__((always_inline));
+
+/**
+ * @brief Initialize the bus of every socket, data lines as input and address lines as output. Socket 0 is selected.
+ * @param sockets Number of sockets, always 1 with BUS_DIRECT
+ * @return True if the backend is ready, false otherwise
+ */
+inline bool bus_init(const uint8_t sockets) {
+#ifdef BUS_DIRECT
+	(void) sockets;
+	BUS_DATA_DDR = 0x00;
+	BUS_DATA_PORT = 0x00;
+	BUS_ADDR_DDR = 0xFF;
+	return true;
+#else
+	return mcp_init(I2C_CLOCK, sockets);
+#endif
+}
+
+/**
+ * @brief Select the socket driven by the other bus functions.
+ * @param socket Socket number
+ */
+inline void bus_select(const uint8_t socket) {
+#ifdef BUS_DIRECT
+	(void) socket;
+#else
+	mcp_select(socket);
+#endif
+}
+
+/**
+ * @brief Set the direction of the data lines.
+ * @param mode INPUT or OUTPUT
+ */
+inline void bus_data_mode(const uint8_t mode) {
+#ifdef BUS_DIRECT
+	BUS_DATA_DDR = mode == OUTPUT ? 0xFF : 0x00;
+#else
+	mcp_set_port_mode(MCP23017_PORTA, mode);
+#endif
+}
+
+/**
+ * @brief Drive the data lines.
+ * @param data Data to write
+ */
+inline void bus_write_data(const uint8_t data) {
+#ifdef BUS_DIRECT
+	BUS_DATA_PORT = data;
+#else
+	mcp_write_port(MCP23017_PORTA, data);
+#endif
+}
+
+/**
+ * @brief Set the lower address bits (A0-A7).
+ * @param address_low Lower address bits
+ */
+inline void bus_write_address(const uint8_t address_low) {
+#ifdef BUS_DIRECT
+	BUS_ADDR_PORT = address_low;
+#else
+	mcp_write_port(MCP23017_PORTB, address_low);
+#endif
+}
+
+/**
+ * @brief Drive the data lines and set the lower address bits, in one MCP23017 transaction.
+ * @param data Data to write
+ * @param address_low Lower address bits (A0-A7)
+ */
+inline void bus_write_data_address(const uint8_t data, const uint8_t address_low) {
+#ifdef BUS_DIRECT
+	BUS_DATA_PORT = data;
+	BUS_ADDR_PORT = address_low;
+#else
+	mcp_write_ports(data, address_low);
+#endif
+}
+
+/**
+ * @brief Read the data lines.
+ * @return Byte containing all 8 lines
+ */
+inline uint8_t bus_read_data() {
+#ifdef BUS_DIRECT
+	return BUS_DATA_PIN;
+#else
+	return mcp_read_port(MCP23017_PORTA);
+#endif
+}
+
+/**
+ * @brief Set the lower address bits and read the data lines once the EEPROM output is valid. The MCP23017 does
+ * both in one transaction, which also covers tACC.
+ * @param address_low Lower address bits (A0-A7)
+ * @return Byte containing all 8 lines
+ */
+inline uint8_t bus_write_address_read(const uint8_t address_low) {
+#ifdef BUS_DIRECT
+	BUS_ADDR_PORT = address_low;
+	__builtin_avr_delay_cycles(BUS_ACC_CYCLES);
+	return BUS_DATA_PIN;
+#else
+	return mcp_write_port_read(MCP23017_PORTB, address_low);
+#endif
+}
+
+#endif //EEPROM_BUS_H
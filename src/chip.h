@@ -0,0 +1,105 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Tomas Vecera, tomas@vecera.dev
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef EEPROM_CHIP_H
+#define EEPROM_CHIP_H
+
+#include "main.h"
+
+/*
+ * Compile-time description of the supported EEPROMs, select one with CHIP_TYPE in main.h. All fields are constant
+ * expressions, so every test on them (if (chip::has_sdp) ...) is resolved by the compiler. Unused address lines,
+ * protection sequences and polling methods do not end up in the binary.
+ */
+
+// AT28C16 - 2 KB, 24-pin package without RDY/BUSY, byte writes only, no software data protection
+struct at28c16 {
+	static constexpr uint32_t size = 2048;
+	static constexpr uint8_t address_bits = 11;      // A0-A10
+	static constexpr uint8_t page_size = 1;          // No page mode
+	static constexpr bool has_sdp = false;           // Software data protection
+	static constexpr uint16_t sdp_address1 = 0;      // SDP command addresses
+	static constexpr uint16_t sdp_address2 = 0;
+	static constexpr bool has_chip_erase = false;    // Software chip erase, via the SDP command addresses
+	static constexpr uint8_t chip_erase_ms = 0;      // tEC maximum
+	static constexpr bool has_toggle_bit = false;    // End of write on I/O6, otherwise DATA polling on I/O7
+	static constexpr bool has_ready_pin = false;     // RDY/BUSY output on pin 1
+	static constexpr uint16_t byte_load_us = 0;      // tBLC maximum, the write cycle starts after it
+	static constexpr uint16_t write_cycle_us = 1000; // tWC maximum
+};
+
+// AT28C64B - 8 KB, 64 byte pages
+struct at28c64 {
+	static constexpr uint32_t size = 8192;
+	static constexpr uint8_t address_bits = 13;      // A0-A12
+	static constexpr uint8_t page_size = 64;
+	static constexpr bool has_sdp = true;
+	static constexpr uint16_t sdp_address1 = 0x1555;
+	static constexpr uint16_t sdp_address2 = 0x0AAA;
+	static constexpr bool has_chip_erase = true;
+	static constexpr uint8_t chip_erase_ms = 20;
+	static constexpr bool has_toggle_bit = true;
+	static constexpr bool has_ready_pin = true;
+	static constexpr uint16_t byte_load_us = 150;
+	static constexpr uint16_t write_cycle_us = 10000;
+};
+
+// AT28C256 - 32 KB, 64 byte pages, pin 1 is A14
+struct at28c256 {
+	static constexpr uint32_t size = 32768;
+	static constexpr uint8_t address_bits = 15;      // A0-A14
+	static constexpr uint8_t page_size = 64;
+	static constexpr bool has_sdp = true;
+	static constexpr uint16_t sdp_address1 = 0x5555;
+	static constexpr uint16_t sdp_address2 = 0x2AAA;
+	static constexpr bool has_chip_erase = true;
+	static constexpr uint8_t chip_erase_ms = 20;
+	static constexpr bool has_toggle_bit = true;
+	static constexpr bool has_ready_pin = false;
+	static constexpr uint16_t byte_load_us = 150;
+	static constexpr uint16_t write_cycle_us = 10000;
+};
+
+#if CHIP_TYPE == 16
+typedef at28c16 chip;
+#define CHIP_NAME    "AT28C16"
+#elif CHIP_TYPE == 64
+typedef at28c64 chip;
+#define CHIP_NAME    "AT28C64"
+#elif CHIP_TYPE == 256
+typedef at28c256 chip;
+#define CHIP_NAME    "AT28C256"
+#else
+#error "Unsupported CHIP_TYPE, use 16, 64 or 256"
+#endif
+
+// Short names for the selected chip
+#define EEPROM_SIZE       chip::size
+#define ADDR_BITS         chip::address_bits
+#define EEPROM_PAGE_SIZE  chip::page_size
+
+// Buffer size for block reads and verifies, one page but at least 64 bytes on parts without page mode
+#define EEPROM_BLOCK_SIZE (EEPROM_PAGE_SIZE > 64 ? EEPROM_PAGE_SIZE : 64)
+
+#endif //EEPROM_CHIP_H
@@ -0,0 +1,84 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Tomas Vecera, tomas@vecera.dev
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "main.h"
+#include "counters.h"
+
+#ifdef COUNTERS
+bus_counters counters;
+
+/**
+ * @brief Print the time of one operation.
+ * @param name Label
+ * @param op COUNT_ERASE to COUNT_TEST
+ */
+static void print_op(const __FlashStringHelper *name, const uint8_t op) {
+	Serial.print(name);
+	Serial.print(counters.op_count[op]);
+	Serial.print(F(" ops, "));
+	Serial.print(counters.op_us[op]);
+	Serial.println(F(" us"));
+}
+#endif
+
+/**
+ * @brief Add the time of one operation.
+ * @param op COUNT_ERASE, COUNT_WRITE, COUNT_VERIFY, COUNT_DUMP, COUNT_TEST or COUNT_NONE (ignored)
+ * @param us Time spent in microseconds
+ */
+void count_op(const uint8_t op, const unsigned long us) {
+#ifdef COUNTERS
+	if (op >= COUNT_OPS) return;
+	counters.op_us[op] += us;
+	if (counters.op_count[op] < UINT16_MAX) counters.op_count[op]++;
+#else
+	(void) op;
+	(void) us;
+#endif
+}
+
+/**
+ * @brief Print all counters and the time per operation, then clear them.
+ */
+void counters_print() {
+#ifdef COUNTERS
+	Serial.print(F("I2C transactions: "));
+	Serial.println(counters.i2c_transactions);
+	Serial.print(F("I2C bytes: "));
+	Serial.println(counters.i2c_bytes);
+	Serial.print(F("GPIO writes: "));
+	Serial.println(counters.gpio_writes);
+	Serial.print(F("Data polls: "));
+	Serial.println(counters.polls);
+
+	print_op(F("Erase: "), COUNT_ERASE);
+	print_op(F("Write: "), COUNT_WRITE);
+	print_op(F("Verify: "), COUNT_VERIFY);
+	print_op(F("Dump: "), COUNT_DUMP);
+	print_op(F("Test: "), COUNT_TEST);
+	memset(&counters, 0, sizeof(counters));
+#else
+	Serial.println(F("Counters not compiled in, see COUNTERS in main.h"));
+#endif
+}
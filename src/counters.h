@@ -0,0 +1,110 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Tomas Vecera, tomas@vecera.dev
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef EEPROM_COUNTERS_H
+#define EEPROM_COUNTERS_H
+
+#include "main.h"
+
+/*
+ * Bus transaction counters and the time spent per operation, printed and cleared by the I command. Every counter is
+ * a plain increment in the hot path, without COUNTERS in main.h they compile to nothing:
+ * - I2C transactions and bytes on the bus including the address byte, counted in mcp23017.cpp
+ * - GPIO writes of CE, OE and WE, and updates of the upper address lines, counted in gpio.h
+ * - Data polls, one per status read of all busy sockets while a write cycle runs
+ * - Time of the erase, write, verify, dump and test commands, text commands, jobs and binary frames alike
+ */
+
+#define COUNT_ERASE    0
+#define COUNT_WRITE    1
+#define COUNT_VERIFY   2
+#define COUNT_DUMP     3
+#define COUNT_TEST     4
+#define COUNT_OPS      5
+#define COUNT_NONE     COUNT_OPS   // Not an operation that is timed
+
+// Counters since power on or the last I command
+struct bus_counters {
+	uint32_t i2c_transactions;
+	uint32_t i2c_bytes;
+	uint32_t gpio_writes;
+	uint32_t polls;
+	uint32_t op_us[COUNT_OPS];      // Time in microseconds, wraps after 71 minutes
+	uint16_t op_count[COUNT_OPS];   // Commands, jobs or frames timed
+};
+
+#ifdef COUNTERS
+extern bus_counters counters;
+#endif
+
+inline void count_i2c(uint8_t bytes) __attribute__((always_inline));
+
+inline void count_gpio() __attribute__((always_inline));
+
+inline void count_poll() __attribute__((always_inline));
+
+/**
+ * @brief Count an I2C transaction.
+ * @param bytes Bytes on the bus, the address byte included
+ */
+inline void count_i2c(const uint8_t bytes) {
+#ifdef COUNTERS
+	counters.i2c_transactions++;
+	counters.i2c_bytes += bytes;
+#else
+	(void) bytes;
+#endif
+}
+
+/**
+ * @brief Count a write of a control or upper address line.
+ */
+inline void count_gpio() {
+#ifdef COUNTERS
+	counters.gpio_writes++;
+#endif
+}
+
+/**
+ * @brief Count a data poll of a running write cycle.
+ */
+inline void count_poll() {
+#ifdef COUNTERS
+	counters.polls++;
+#endif
+}
+
+/**
+ * @brief Add the time of one operation.
+ * @param op COUNT_ERASE, COUNT_WRITE, COUNT_VERIFY, COUNT_DUMP, COUNT_TEST or COUNT_NONE (ignored)
+ * @param us Time spent in microseconds
+ */
+void count_op(uint8_t op, unsigned long us);
+
+/**
+ * @brief Print all counters and the time per operation, then clear them.
+ */
+void counters_print();
+
+#endif //EEPROM_COUNTERS_H
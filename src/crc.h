@@ -0,0 +1,63 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Tomas Vecera, tomas@vecera.dev
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef EEPROM_CRC_H
+#define EEPROM_CRC_H
+
+#include <util/crc16.h>
+
+#define CRC16_INIT  0xFFFF
+#define CRC32_INIT  0xFFFFFFFFUL
+
+inline uint16_t crc16_update(uint16_t crc, uint8_t data) __attribute__((always_inline));
+
+inline uint32_t crc32_update(uint32_t crc, uint8_t data) __attribute__((always_inline));
+
+/**
+ * @brief Update a CRC-16/CCITT-FALSE (polynomial 0x1021, MSB first, init 0xFFFF) with one byte.
+ * Matches binascii.crc_hqx(data, 0xFFFF) on the host.
+ * @param crc Current CRC value
+ * @param data Data byte
+ * @return Updated CRC value
+ */
+uint16_t crc16_update(const uint16_t crc, const uint8_t data) {
+	return _crc_xmodem_update(crc, data);
+}
+
+/**
+ * @brief Update a CRC-32 (IEEE 802.3, reflected polynomial 0xEDB88320) with one byte. Start with CRC32_INIT and
+ * invert the result, then it matches zlib.crc32(data) on the host. Bitwise, as a table would need 1 KB of RAM.
+ * @param crc Current CRC value
+ * @param data Data byte
+ * @return Updated CRC value
+ */
+uint32_t crc32_update(uint32_t crc, const uint8_t data) {
+	crc ^= data;
+	for (uint8_t i = 0; i < 8; i++) {
+		crc = (crc >> 1) ^ (0xEDB88320UL & -(crc & 1));
+	}
+	return crc;
+}
+
+#endif //EEPROM_CRC_H
@@ -0,0 +1,102 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Tomas Vecera, tomas@vecera.dev
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef EEPROM_GPIO_H
+#define EEPROM_GPIO_H
+
+#include "main.h"
+#include "at28c.h"
+#include "counters.h"
+
+/*
+ * Fast GPIO for the control and upper address lines. On the ATmega328P (Uno, Nano) the pins are driven
+ * through the port registers directly - digital pins 0-7 are PORTD, 8-13 are PORTB, 14-19 (A0-A5) are PORTC.
+ * With a constant pin number gpio_low() and gpio_high() compile to a single CBI/SBI instruction. Other boards
+ * fall back to digitalWrite().
+ */
+#if defined(__AVR_ATmega328P__) || defined(__AVR_ATmega168__)
+
+#define GPIO_PORT(pin)     ((pin) < 8 ? PORTD : (pin) < 14 ? PORTB : PORTC)
+#define GPIO_INPUT(pin)    ((pin) < 8 ? PIND : (pin) < 14 ? PINB : PINC)
+#define GPIO_BIT(pin)      ((pin) < 8 ? (pin) : (pin) < 14 ? (pin) - 8 : (pin) - 14)
+
+#define gpio_low(pin)      (count_gpio(), GPIO_PORT(pin) &= ~_BV(GPIO_BIT(pin)))
+#define gpio_high(pin)     (count_gpio(), GPIO_PORT(pin) |= _BV(GPIO_BIT(pin)))
+#define gpio_read(pin)     ((GPIO_INPUT(pin) & _BV(GPIO_BIT(pin))) != 0)
+
+// A8 and up are expected on consecutive pins, starting on PORTD and continuing on PORTB from pin 8
+static_assert(A8_PIN < 8 && A9_PIN == A8_PIN + 1 && A10_PIN == A8_PIN + 2 && A11_PIN == A8_PIN + 3 &&
+              A12_PIN == A8_PIN + 4 && A13_PIN == A8_PIN + 5 && A14_PIN == A8_PIN + 6,
+              "Fast GPIO requires A8-A14 on consecutive Arduino pins");
+
+#define GPIO_PORTD_LINES   (8 - A8_PIN)                               // A8.. on PORTD
+#define GPIO_PORTD_MASK    (((1 << GPIO_PORTD_LINES) - 1) << A8_PIN)
+#define GPIO_PORTB_MASK    ((1 << (ADDR_BITS - 8 - GPIO_PORTD_LINES)) - 1) // A11.. from PB0, none on the AT28C16
+
+inline void gpio_address_high(uint16_t address) __attribute__((always_inline));
+
+/**
+ * @brief Set the upper address bits (A8 up to the highest address bit of the chip) with one PORTD and one PORTB update.
+ * @param address EEPROM address
+ */
+inline void gpio_address_high(const uint16_t address) {
+	count_gpio();
+	const uint8_t high = address >> 8;
+	PORTD = (PORTD & ~GPIO_PORTD_MASK) | ((high << A8_PIN) & GPIO_PORTD_MASK);
+	if (GPIO_PORTB_MASK != 0) {
+		PORTB = (PORTB & ~GPIO_PORTB_MASK) | ((high >> GPIO_PORTD_LINES) & GPIO_PORTB_MASK);
+	}
+}
+
+#else
+
+#define gpio_low(pin)      (count_gpio(), digitalWrite(pin, LOW))
+#define gpio_high(pin)     (count_gpio(), digitalWrite(pin, HIGH))
+#define gpio_read(pin)     (digitalRead(pin) == HIGH)
+
+inline void gpio_address_high(uint16_t address) __attribute__((always_inline));
+
+/**
+ * @brief Set the upper address bits (A8 up to the highest address bit of the chip) using Arduino pins.
+ * @param address EEPROM address
+ */
+inline void gpio_address_high(const uint16_t address) {
+	count_gpio();
+	digitalWrite(A8_PIN, (address >> 8) & 1);
+	digitalWrite(A9_PIN, (address >> 9) & 1);
+	digitalWrite(A10_PIN, (address >> 10) & 1);
+
+	if (ADDR_BITS > 11) {
+		digitalWrite(A11_PIN, (address >> 11) & 1);
+		digitalWrite(A12_PIN, (address >> 12) & 1);
+	}
+	if (ADDR_BITS > 13) {
+		digitalWrite(A13_PIN, (address >> 13) & 1);
+		digitalWrite(A14_PIN, (address >> 14) & 1);
+	}
+}
+
+#endif
+
+#endif //EEPROM_GPIO_H
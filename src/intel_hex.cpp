@@ -27,133 +27,301 @@
 #include "intel_hex.h"
 #include "util.h"
 
-#define MAX_LINE_LENGTH 45
+#define MAX_DATA_LENGTH 64 // Longest accepted data record
+#define RECORD_HEADER   4  // Byte count, address (2 bytes) and record type
 
-static char input_buffer[MAX_LINE_LENGTH + 1];
-int input_index = 0;
+// Record decoded from the input line: header, data and checksum
+static uint8_t record[RECORD_HEADER + MAX_DATA_LENGTH + 1];
+static uint8_t record_length = 0; // Bytes decoded so far
+static uint8_t record_sum = 0;    // Sum of all decoded bytes, zero for a valid record
+static bool nibble_high = true;   // Next hex digit is the upper half of a byte
+static bool line_started = false; // Any character other than CR received on this line
+static bool line_error = false;   // Error already reported for this line
+static uint32_t base_address = 0; // Set by extended segment and linear address records
 
 /**
- * @brief Processes a single line of Intel HEX format data and writes it to EEPROM
+ * Page assembly buffer. Two of them form a pipeline: while one page is in its write cycle, the records for the
+ * next page are received into the other one.
+ */
+struct hex_page {
+	uint16_t address;                             // Page start address
+	uint8_t data[EEPROM_PAGE_SIZE];               // Page contents
+	uint8_t loaded[(EEPROM_PAGE_SIZE + 7) / 8];   // Bitmap of bytes set by the HEX input
+	bool used;                                    // Page holds data to write or verify
+};
+
+static hex_page pages[2];
+static uint8_t fill_page = 0;      // Page receiving records, the other one is being written
+static uint16_t pages_written = 0; // Pages that needed a write cycle
+
+/**
+ * @brief Finish the previous page and start the write cycle of the page being filled. The previous page is verified
+ * first, which also waits until its write cycle completes. Bytes not set by the HEX input keep the EEPROM contents
+ * and only changed bytes are loaded. The other buffer is free for new records afterwards. A failed verify prints the
+ * address of the page, the NAK goes to the line being processed, which belongs to a later page.
+ * @return True if the previous page was verified successfully, false otherwise
+ */
+static bool page_flush() {
+	hex_page &page = pages[fill_page];
+	hex_page &prev = pages[fill_page ^ 1];
+	bool result = true;
+
+	if (prev.used) {
+		result = eeprom_verify_block(prev.address, prev.data, EEPROM_PAGE_SIZE) == 0;
+		prev.used = false;
+
+		// Reported on the line that starts a later page, so the message names the failed page
+		if (!result) {
+			Serial.print(F("Error: Verification failed in page 0x"));
+			Serial.println(prev.address, HEX);
+		}
+	}
+
+	if (page.used) {
+		uint8_t current[EEPROM_PAGE_SIZE];
+		eeprom_read_block(page.address, current, sizeof(current));
+
+		for (uint8_t i = 0; i < EEPROM_PAGE_SIZE; i++) {
+			if (!(page.loaded[i / 8] & (1 << (i % 8)))) page.data[i] = current[i];
+		}
+
+		if (memcmp(current, page.data, EEPROM_PAGE_SIZE) != 0) {
+			eeprom_write_page_start(page.address, page.data, EEPROM_PAGE_SIZE, current);
+			pages_written++;
+		}
+
+		fill_page ^= 1;
+	}
+
+	return result;
+}
+
+/**
+ * @brief Store data into the page being filled, up to the page boundary. Starts the write of the page when the
+ * data belongs to another page.
+ * @param address EEPROM address of the first byte
+ * @param data Data bytes
+ * @param len Number of bytes
+ * @param result Set to false if the verification of a finished page failed
+ * @return Number of bytes stored
+ */
+static uint8_t page_put(const uint16_t address, const uint8_t *data, const uint8_t len, bool *result) {
+	const uint16_t page_address = address & ~(EEPROM_PAGE_SIZE - 1);
+
+	if (pages[fill_page].used && pages[fill_page].address != page_address) {
+		if (!page_flush()) *result = false;
+	}
+
+	hex_page &page = pages[fill_page];
+	if (!page.used) {
+		page.address = page_address;
+		memset(page.loaded, 0, sizeof(page.loaded));
+		page.used = true;
+	}
+
+	const uint8_t offset = address & (EEPROM_PAGE_SIZE - 1);
+	const uint8_t count = min(len, EEPROM_PAGE_SIZE - offset);
+	memcpy(&page.data[offset], data, count);
+	for (uint8_t i = offset; i < offset + count; i++) {
+		page.loaded[i / 8] |= 1 << (i % 8);
+	}
+
+	return count;
+}
+
+/**
+ * @brief Write and verify the remaining pages at the end of the HEX input.
+ * @return True if all pages were verified successfully, false otherwise
+ */
+static bool page_finish() {
+	const bool result = page_flush(); // Starts the last page
+	return page_flush() && result;    // Verifies it
+}
+
+/**
+ * @brief Clear the decoder state for the next line
+ */
+static void line_reset() {
+	record_length = 0;
+	record_sum = 0;
+	nibble_high = true;
+	line_started = false;
+	line_error = false;
+}
+
+/**
+ * @brief Print an error for the current line, only the first one is reported.
+ * @param message Error message
+ */
+static void line_fail(const __FlashStringHelper *message) {
+	if (line_error) return;
+	Serial.print(F("Error: "));
+	Serial.println(message);
+	line_error = true;
+}
+
+/**
+ * @brief Processes a complete Intel HEX record decoded from one line
  *
- * This function parses and processes a line of Intel HEX format, performing the following:
- *	- Validates line length and start character (':')
- *	- Extracts and converts hex values for byte count, address, and record type
- *	- Handles different record types:
- *		- 0x00: Data record (writes data to EEPROM with verification)
- *		- 0x01: End of file record
- *		- Others: Treated as unsupported
+ * The record has been checked for length and checksum already. Handles different record types:
+ *	- 0x00: Data record (stored into the page buffers, written and verified when the next page starts)
+ *	- 0x01: End of file record
+ *	- 0x02: Extended segment address record (address bits 4-19)
+ *	- 0x03, 0x05: Start address records (ignored)
+ *	- 0x04: Extended linear address record (address bits 16-31)
  *
  * Format: :BBAAAATTDD...CC where:
  *  - BB: Byte count
  *  - AAAA: Address
  *  - TT: Record type
  *  - DD: Data bytes
- *  - CC: Checksum (not currently verified)
+ *  - CC: Checksum, two's complement of the sum of all other bytes
  *
- * @param line Pointer to null-terminated string containing a single Intel HEX format line
  * @return uint8_t Status code:
  *         - 0 (false): Error occurred during processing
- *         - 1 (true): Line processed successfully
+ *         - 1 (true): Record processed successfully
  *         - 2: End of file record processed successfully
  */
-static uint8_t hex_process_line(const char *line) {
-	if (strlen(line) < 11) {
-		Serial.println(F("Error: Line too short"));
-		return false;
-	}
-
-	// Check start character
-	if (line[0] != ':') {
-		Serial.println(F("Error: Missing start character (:)"));
-		return false;
-	}
+static uint8_t hex_process_record() {
+	const uint8_t byte_count = record[0];
+	const uint16_t offset = (record[1] << 8) | record[2];
+	const uint8_t record_type = record[3];
+	const uint8_t *data = &record[RECORD_HEADER];
 
-	// Convert hex values
-	const uint8_t byte_count = (hex_char_to_int(line[1]) << 4) | hex_char_to_int(line[2]);
-	const uint16_t address = (hex_char_to_int(line[3]) << 12) | (hex_char_to_int(line[4]) << 8) |
-	                         (hex_char_to_int(line[5]) << 4) | hex_char_to_int(line[6]);
-	const uint8_t record_type = (hex_char_to_int(line[7]) << 4) | hex_char_to_int(line[8]);
-
-	Serial.print(F("Line - Type: "));
-	Serial.print(record_type, HEX);
-	if (record_type == 0x00) {
-		Serial.print(F(", Address: "));
-		Serial.print(address, HEX);
-		Serial.print(F("h, Byte count: "));
-		Serial.println(byte_count);
-	}
-
-	// Handle record types
 	switch (record_type) {
-		case 0x00: // Data record
-			// Write data to EEPROM
-			for (uint8_t i = 0; i < byte_count; i++) {
-				const uint8_t data = (hex_char_to_int(line[9 + i * 2]) << 4) | hex_char_to_int(line[10 + i * 2]);
-				eeprom_write_byte(address + i, data);
-
-				// Optional: Add verification
-				const uint8_t read_back = eeprom_read_byte(address + i);
-				if (read_back != data) {
-					Serial.print(F("Verification failed at 0x"));
-					Serial.print(address + i, HEX);
-					Serial.print(F(": wrote 0x"));
-					Serial.print(data, HEX);
-					Serial.print(F(", read 0x"));
-					Serial.println(read_back, HEX);
-					return false;
-				}
+		case 0x00: {
+			// Data record
+			const uint32_t address = base_address + offset;
+			if (address + byte_count > EEPROM_SIZE) {
+				line_fail(F("Address out of range"));
+				return false;
 			}
-			break;
+
+			// Feed the data in page sized chunks, a record can cross a page boundary
+			bool result = true;
+			for (uint8_t i = 0; i < byte_count;) {
+				i += page_put(address + i, &data[i], byte_count - i, &result);
+			}
+			return result;
+		}
 
 		case 0x01: // End of file record
-			Serial.println(F("\nHex input complete."));
 			return 2;
 
+		case 0x02: // Extended segment address record
+		case 0x04: // Extended linear address record
+			if (byte_count != 2) {
+				line_fail(F("Invalid address record"));
+				return false;
+			}
+			base_address = static_cast<uint32_t>((data[0] << 8) | data[1]) << (record_type == 0x02 ? 4 : 16);
+			return true;
+
+		case 0x03: // Start segment address record
+		case 0x05: // Start linear address record
+			return true;
+
 		default:
-			Serial.print(F("Unsupported record type: "));
-			Serial.println(record_type, HEX);
+			line_fail(F("Unsupported record type"));
 			return false;
 	}
+}
+
+/**
+ * @brief Finish the current line. A record is processed after its length and checksum have been checked.
+ * An empty line ends the input.
+ * @return Status code like hex_process_record()
+ */
+static uint8_t hex_process_line() {
+	if (!line_started) return 2;
+	if (line_error) return false;
+
+	if (record_length < RECORD_HEADER + 1 || record_length != RECORD_HEADER + record[0] + 1 || !nibble_high) {
+		line_fail(F("Invalid record length"));
+		return false;
+	}
 
-	return true;
+	if (record_sum != 0) {
+		line_fail(F("Checksum mismatch"));
+		return false;
+	}
+
+	return hex_process_record();
 }
 
 /**
- * @brief Process a single character from the Intel HEX input
+ * @brief Decode one character of a record. Hex digits are combined into bytes as they arrive, so no line buffer is needed.
  * @param c Character to process
- * @return True if the character was processed successfully, false otherwise
+ */
+static void hex_decode_char(const char c) {
+	if (line_error) return;
+
+	if (!line_started) {
+		line_started = true;
+		if (c != ':') line_fail(F("Missing start character (:)"));
+		return;
+	}
+
+	if (!isxdigit(c)) {
+		line_fail(F("Invalid character"));
+		return;
+	}
+
+	if (record_length == sizeof(record)) {
+		line_fail(F("Too many data bytes"));
+		return;
+	}
+
+	if (nibble_high) {
+		record[record_length] = hex_char_to_int(c) << 4;
+	} else {
+		record[record_length] |= hex_char_to_int(c);
+		record_sum += record[record_length++];
+	}
+	nibble_high = !nibble_high;
+}
+
+/**
+ * @brief Process a single character from the Intel HEX input. Every line is answered with ACK or NAK after it
+ * was processed and the host must wait for it before sending the next line. Processing a line never waits for
+ * the write cycle of the page it fills, so the next line is received while the EEPROM writes.
+ * @param c Character to process
+ * @return True if the character was processed successfully, false otherwise, 2 at the end of the input
  */
 uint8_t hex_process_char(const char c) {
 	// Ignore carriage return
 	if (c == '\r') return true;
 
-	if (c == '\n') {
-		input_buffer[input_index] = 0; // Null terminate
-
-		if (input_index == 0) {
-			return 2;
-		}
+	if (c != '\n') {
+		hex_decode_char(c);
+		return true;
+	}
 
-		const uint8_t status = hex_process_line(input_buffer);
-		if (!status) {
-			Serial.println(F("Error processing hex line!"));
-		}
+	uint8_t status = hex_process_line();
+	if (status == 2) {
+		if (!page_finish()) status = false;
 
-		input_index = 0;
-		return status;
+		Serial.println(F("\nHex input complete."));
+		Serial.print(F("Pages written: "));
+		Serial.println(pages_written);
 	}
 
-	if (input_index < MAX_LINE_LENGTH) {
-		input_buffer[input_index++] = c;
+	if (!status) {
+		Serial.println(F("Error processing hex line!"));
 	}
+	Serial.println(status ? F("ACK") : F("NAK"));
 
-	return true;
+	line_reset();
+	return status;
 }
 
 /**
- * @brief Reset the Intel HEX input buffer
+ * @brief Reset the Intel HEX input buffer and the page pipeline
  */
 void hex_process_reset() {
-	input_index = 0;
-	memset(input_buffer, 0, sizeof(input_buffer));
+	line_reset();
+	base_address = 0;
+	memset(pages, 0, sizeof(pages));
+	fill_page = 0;
+	pages_written = 0;
 }
@@ -26,14 +26,16 @@
 #define EEPROM_HEX_H
 
 /**
- * @brief Process a single character from the Intel HEX input
+ * @brief Process a single character from the Intel HEX input. Every line is answered with ACK or NAK after it
+ * was processed and the host must wait for it before sending the next line. Processing a line never waits for
+ * the write cycle of the page it fills, so the next line is received while the EEPROM writes.
  * @param c Character to process
- * @return True if the character was processed successfully, false otherwise
+ * @return True if the character was processed successfully, false otherwise, 2 at the end of the input
  */
 uint8_t hex_process_char(char c);
 
 /**
- * @brief Reset the Intel HEX input buffer
+ * @brief Reset the Intel HEX input buffer and the page pipeline
  */
 void hex_process_reset();
 
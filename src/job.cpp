@@ -0,0 +1,272 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Tomas Vecera, tomas@vecera.dev
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "main.h"
+#include "job.h"
+#include "at28c.h"
+#include "counters.h"
+#include "progress.h"
+#include "util.h"
+
+#define JOB_IDLE     0
+#define JOB_LOAD     1   // Fill the next page and load it
+#define JOB_WAIT     2   // Poll the write cycle
+#define JOB_VERIFY   3   // Read the page back
+
+// The running job
+static struct {
+	uint8_t state;
+	char operation;                  // Operation code of the progress reports
+	uint8_t flags;
+	uint16_t start;
+	uint16_t end;
+	uint16_t done;                   // Bytes of the pages before the current one
+	uint16_t address;                // First byte of the current page
+	uint8_t len;                     // Bytes of the current page
+	bool abort;
+	job_source source;
+	job_done done_callback;
+	unsigned long start_time;
+	job_result result;
+	uint8_t page[EEPROM_PAGE_SIZE];
+} job;
+
+static uint8_t erase_pattern;
+
+/**
+ * @brief Start a job. A job that is still running is dropped after its write cycle, without its done callback.
+ * The job begins in WAIT, so a write cycle still running, like a chip erase, is polled by job_step() as well.
+ * @param operation Operation code of the progress reports, see progress.h
+ * @param start Start address
+ * @param end End address (exclusive)
+ * @param source Page data
+ * @param flags JOB_UPDATE, JOB_DOWN, JOB_READ
+ * @param done Called when the job is over, can be nullptr
+ */
+void job_start(const char operation, const uint16_t start, uint16_t end, const job_source source,
+               const uint8_t flags, const job_done done) {
+	if (end > EEPROM_SIZE) end = EEPROM_SIZE;
+
+	job.operation = operation;
+	job.start = start;
+	job.end = start < end ? end : start;
+	job.flags = flags;
+	job.done = 0;
+	job.address = (flags & JOB_DOWN) ? job.end : job.start;
+	job.len = 0;
+	job.abort = false;
+	job.source = source;
+	job.done_callback = done;
+	job.start_time = millis();
+	job.result = {};
+	job.state = JOB_WAIT;
+	progress_start(operation, job.end - job.start);
+}
+
+/**
+ * @brief Get the next address to be processed, for the progress reports.
+ */
+static uint16_t job_position() {
+	return (job.flags & JOB_DOWN) ? job.end - job.done : job.start + job.done;
+}
+
+/**
+ * @brief Get the counter of a job operation, see counters.h.
+ */
+static uint8_t job_counter(const char operation) {
+	switch (operation) {
+		case 'E': return COUNT_ERASE;
+		case 'R': return COUNT_WRITE;
+		case 'T': return COUNT_TEST;
+		default: return COUNT_NONE;
+	}
+}
+
+/**
+ * @brief End the current job and call its done callback, which may start the next one.
+ */
+static void job_finish() {
+	job.result.ms = millis() - job.start_time;
+	job.result.aborted = job.abort;
+	job.state = JOB_IDLE;
+	progress_end(job_position(), job.done, job.result.errors);
+	count_op(job_counter(job.operation), job.result.ms * 1000UL);
+
+	const job_result result = job.result;
+	if (job.done_callback != nullptr) job.done_callback(&result);
+}
+
+/**
+ * @brief Select the next page of the range, upwards from the start or downwards from the end.
+ */
+static void job_next_page() {
+	if (job.flags & JOB_DOWN) {
+		const uint16_t top = job.end - job.done;
+		const uint16_t page = (top - 1) & ~(EEPROM_PAGE_SIZE - 1);
+		job.address = page > job.start ? page : job.start;
+		job.len = top - job.address;
+	} else {
+		const uint16_t room = EEPROM_PAGE_SIZE - ((job.start + job.done) & (EEPROM_PAGE_SIZE - 1));
+		job.address = job.start + job.done;
+		job.len = job.end - job.address < room ? job.end - job.address : room;
+	}
+}
+
+/**
+ * @brief JOB_LOAD - fill the next page and load it, the write cycle runs on its own.
+ */
+static void job_load() {
+	job_next_page();
+	job.source(job.address, job.page, job.len);
+
+	if (job.flags & JOB_READ) {
+		job.state = JOB_VERIFY;
+		return;
+	}
+
+	uint8_t current[EEPROM_PAGE_SIZE];
+	const bool update = job.flags & JOB_UPDATE;
+	if (update) {
+		eeprom_read_block(job.address, current, job.len);
+		if (memcmp(current, job.page, job.len) != 0) job.result.written++;
+	} else {
+		job.result.written++;
+	}
+
+	eeprom_write_page_start(job.address, job.page, job.len, update ? current : nullptr);
+	job.state = JOB_WAIT;
+}
+
+/**
+ * @brief JOB_VERIFY - read the page back, then continue with the next one.
+ */
+static void job_verify() {
+	if (job.len != 0) {
+		job.result.errors += eeprom_verify_block(job.address, job.page, job.len);
+		job.result.pages++;
+		job.done += job.len;
+		progress_update(job_position(), job.done, job.result.errors);
+	}
+
+	if (job.done >= job.end - job.start || job.abort) {
+		job_finish();
+	} else {
+		job.state = JOB_LOAD;
+	}
+}
+
+/**
+ * @brief Run one state of the current job. Call it from loop(), it returns without waiting for the EEPROM.
+ * @return True while a job is running
+ */
+bool job_step() {
+	switch (job.state) {
+		case JOB_LOAD:
+			if (job.abort) {
+				job_finish();
+			} else {
+				job_load();
+			}
+			break;
+
+		case JOB_WAIT:
+			if (eeprom_write_done()) job.state = JOB_VERIFY;
+			break;
+
+		case JOB_VERIFY:
+			job_verify();
+			break;
+
+		default:
+			break;
+	}
+	return job.state != JOB_IDLE;
+}
+
+/**
+ * @brief Check whether a job is running.
+ * @return True while a job is running
+ */
+bool job_running() {
+	return job.state != JOB_IDLE;
+}
+
+/**
+ * @brief Stop the current job after the page being written, its done callback gets aborted = true.
+ */
+void job_abort() {
+	if (job.state != JOB_IDLE) job.abort = true;
+}
+
+/**
+ * @brief Page data of eeprom_erase_section(), every byte is the pattern.
+ */
+static void erase_source(const uint16_t address, uint8_t *buf, const uint8_t len) {
+	memset(buf, erase_pattern, len);
+}
+
+/**
+ * @brief End of eeprom_erase_section().
+ */
+static void erase_done(const job_result *result) {
+	if (result->aborted) {
+		Serial.println(F("\nErase aborted!"));
+	} else {
+		Serial.println(F("\nErase Done!"));
+	}
+	Serial.print(F("Pages written: "));
+	Serial.print(result->written);
+	Serial.print(F(" of "));
+	Serial.println(result->pages);
+	if (result->errors != 0) {
+		Serial.print(F("Verification failed: "));
+		Serial.print(result->errors);
+		Serial.println(F(" bytes"));
+	}
+	print_execution_time(result->ms);
+}
+
+/**
+ * @brief Start erasing a section of the EEPROM by writing a pattern to all bytes. Pages that already hold the
+ * pattern are skipped. The whole EEPROM with 0xFF is erased by the software chip erase first, if the part has it,
+ * then the job polls it to completion, verifies it and writes any page that is not blank.
+ * @param start Start address
+ * @param end End address
+ * @param pattern Pattern to write
+ */
+void eeprom_erase_section(const uint16_t start, const uint16_t end, const uint8_t pattern) {
+	Serial.print(F("Erasing EEPROM from 0x"));
+	Serial.print(start, HEX);
+	Serial.print(F(" to 0x"));
+	Serial.print(end - 1, HEX);
+	Serial.print(F(" with pattern 0x"));
+	Serial.println(pattern, HEX);
+
+	if (start == 0 && end >= EEPROM_SIZE && pattern == 0xFF && eeprom_chip_erase()) {
+		Serial.println(F("Chip erase, then verifying"));
+	}
+
+	erase_pattern = pattern;
+	job_start('E', start, end, erase_source, JOB_UPDATE, erase_done);
+}
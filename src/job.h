@@ -0,0 +1,107 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Tomas Vecera, tomas@vecera.dev
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef EEPROM_JOB_H
+#define EEPROM_JOB_H
+
+#include <Arduino.h>
+
+/*
+ * Non-blocking write engine for long jobs (erase, ROM write, test). A job writes an address range page by page:
+ *
+ *   LOAD (fill the page, load the bytes) -> WAIT (poll the write cycle) -> VERIFY (read back) -> next page
+ *
+ * job_step() runs one state and returns, loop() calls it between serial reads. Progress reports, an abort and the
+ * binary frames that only read keep working while the job runs, they wait for the write cycle first. Frames that
+ * write, select a socket or change the baud rate get STATUS_BUSY until the job is done, see protocol.h.
+ */
+
+// Flags of job_start()
+#define JOB_UPDATE   0x01   // Skip bytes that already match, pages that match entirely get no write cycle
+#define JOB_DOWN     0x02   // Pages from the end of the range down to its start
+#define JOB_READ     0x04   // Only compare the pages with the source data, nothing is written
+
+// Result of a finished job, passed to its done callback
+struct job_result {
+	uint16_t pages;      // Pages processed
+	uint16_t written;    // Pages that needed a write cycle, none with JOB_READ
+	uint32_t errors;     // Bytes that did not verify, summed over all sockets
+	unsigned long ms;    // Time from job_start()
+	bool aborted;        // Stopped by job_abort()
+};
+
+/**
+ * @brief Fill the data of one page. Called right before the page is loaded, so it may also check the current contents.
+ * @param address EEPROM address of the first byte
+ * @param buf Buffer for the data
+ * @param len Number of bytes
+ */
+typedef void (*job_source)(uint16_t address, uint8_t *buf, uint8_t len);
+
+/**
+ * @brief Called once when a job finishes or is aborted. May start the next job.
+ * @param result Counts of the job
+ */
+typedef void (*job_done)(const job_result *result);
+
+/**
+ * @brief Start a job. A job that is still running is dropped after its write cycle, without its done callback.
+ * The job begins in WAIT, so a write cycle still running, like a chip erase, is polled by job_step() as well.
+ * @param operation Operation code of the progress reports, see progress.h
+ * @param start Start address
+ * @param end End address (exclusive)
+ * @param source Page data
+ * @param flags JOB_UPDATE, JOB_DOWN, JOB_READ
+ * @param done Called when the job is over, can be nullptr
+ */
+void job_start(char operation, uint16_t start, uint16_t end, job_source source, uint8_t flags, job_done done);
+
+/**
+ * @brief Run one state of the current job. Call it from loop(), it returns without waiting for the EEPROM.
+ * @return True while a job is running
+ */
+bool job_step();
+
+/**
+ * @brief Check whether a job is running.
+ * @return True while a job is running
+ */
+bool job_running();
+
+/**
+ * @brief Stop the current job after the page being written, its done callback gets aborted = true.
+ */
+void job_abort();
+
+/**
+ * @brief Start erasing a section of the EEPROM by writing a pattern to all bytes. Pages that already hold the
+ * pattern are skipped. The whole EEPROM with 0xFF is erased by the software chip erase first, if the part has it,
+ * then the job polls it to completion, verifies it and writes any page that is not blank.
+ * @param start Start address
+ * @param end End address
+ * @param pattern Pattern to write
+ */
+void eeprom_erase_section(uint16_t start, uint16_t end, uint8_t pattern);
+
+#endif //EEPROM_JOB_H
@@ -24,28 +24,43 @@
 
 #include "main.h"
 #include "at28c.h"
+#include "bench.h"
+#include "counters.h"
 #include "intel_hex.h"
+#include "job.h"
+#include "protocol.h"
 #include "rom.h"
+#include "stats.h"
 #include "test.h"
 #include "util.h"
 
+// A job started from a text command is running, print the help when it is over
+static bool job_prompt = false;
+
 void print_help() {
 	Serial.println();
 	Serial.println(F("Commands:"));
 	Serial.println(F(" E - Erase EEPROM"));
-	Serial.println(F(" T - Full EEPROM test"));
+	Serial.println(F(" T - EEPROM test"));
 	Serial.println(F(" D - Dump EEPROM contents"));
+	Serial.println(F(" F - Stream EEPROM contents (no pagination)"));
+	Serial.println(F(" K - Blank check"));
 	Serial.println(F(" W - Write Intel HEX data to EEPROM"));
-	Serial.println(F(" R - Write default ROM data from UNO flash"));
+	Serial.println(F(" R - Write a ROM image from UNO flash"));
+	Serial.println(F(" C - Check a ROM image (CRC32)"));
 	Serial.println(F(" X - Enable write protection"));
 	Serial.println(F(" S - Disable write protection"));
+	Serial.println(F(" H - Write cycle statistics"));
+	Serial.println(F(" B - Benchmark"));
+	Serial.println(F(" I - Bus counters and time per operation (cleared after printing)"));
+	if (EEPROM_SOCKETS > 1) Serial.println(F(" N - Select socket for reads"));
 	Serial.println(F(" ? - Help"));
 	Serial.println();
 	Serial.print(F(">"));
 }
 
 void setup() {
-	Serial.begin(115200);
+	Serial.begin(SERIAL_BAUD);
 	while (!Serial) delay(10);
 
 	Serial.println();
@@ -56,6 +71,10 @@ void setup() {
 	Serial.println(F(CHIP_NAME));
 	Serial.print(F("Memory size:   "));
 	Serial.println(EEPROM_SIZE);
+	if (EEPROM_SOCKETS > 1) {
+		Serial.print(F("Sockets:       "));
+		Serial.println(EEPROM_SOCKETS);
+	}
 
 	// Initialize MCP23017
 	if (!eeprom_init()) {
@@ -72,6 +91,7 @@ void dump_eeprom() {
 	const uint16_t start_addr = get_hex_value(4, 0) % EEPROM_SIZE;
 
 	uint8_t linesOnPage = 0;
+	uint8_t line[16];
 
 	for (uint32_t addr = start_addr; addr < EEPROM_SIZE; addr++) {
 		// Print address at start of line
@@ -108,17 +128,57 @@ void dump_eeprom() {
 			Serial.print(F(": "));
 		}
 
+		// Read the rest of the line in one block
+		if (addr == start_addr || (addr & 0x0F) == 0) {
+			eeprom_read_block(addr, &line[addr & 0x0F], 16 - (addr & 0x0F));
+		}
+
 		// Print data byte
-		const uint8_t data = eeprom_read_byte(addr);
+		const uint8_t data = line[addr & 0x0F];
 		if (data < 0x10) Serial.print('0');
 		Serial.print(data, HEX);
 		Serial.print(' ');
+	}
+}
 
-		// Add delay every 256 bytes to allow serial buffer to clear
-		if ((addr & 0xFF) == 0xFF) {
-			delay(100);
+void stream_eeprom() {
+	Serial.println();
+	Serial.print(F("Start: "));
+	const uint16_t start = get_hex_value(4, 0) % EEPROM_SIZE;
+	Serial.println();
+	Serial.print(F("Length: "));
+	uint16_t len = get_hex_value(4, 0);
+	if (len == 0 || len > EEPROM_SIZE - start) len = EEPROM_SIZE - start;
+
+	// Serial.print() blocks while the transmit buffer is full, so the UART paces the dump
+	const unsigned long started = micros();
+	const uint32_t end = static_cast<uint32_t>(start) + len;
+	uint8_t line[16];
+	for (uint32_t addr = start; addr < end;) {
+		if (Serial.available()) {
+			const char c = static_cast<char>(Serial.read());
+			if (toupper(c) == 'Q' || c == 0x1B) break;
+		}
+
+		// Lines end at 16 byte boundaries, only the first one may be shorter
+		const uint8_t count = min(16 - (addr & 0x0F), end - addr);
+		eeprom_read_block(addr, line, count);
+
+		Serial.println();
+		if (addr < 0x1000) Serial.print('0');
+		if (addr < 0x100) Serial.print('0');
+		if (addr < 0x10) Serial.print('0');
+		Serial.print(addr, HEX);
+		Serial.print(F(": "));
+		for (uint8_t i = 0; i < count; i++) {
+			if (line[i] < 0x10) Serial.print('0');
+			Serial.print(line[i], HEX);
+			Serial.print(' ');
 		}
+		addr += count;
 	}
+	Serial.println();
+	count_op(COUNT_DUMP, micros() - started);
 }
 
 void erase_eeprom() {
@@ -133,9 +193,7 @@ void erase_eeprom() {
 	const uint8_t pattern = get_hex_value(2, 0xFF);
 	Serial.println();
 
-	const unsigned long start_time = millis();
 	eeprom_erase_section(start, end == 0x0000 ? EEPROM_SIZE : end, pattern);
-	print_execution_time(millis() - start_time);
 }
 
 void hex_write() {
@@ -147,6 +205,7 @@ void hex_write() {
 	Serial.println(F("Enter Intel HEX data (finish with empty line):"));
 	hex_process_reset();
 
+	const unsigned long started = micros();
 	while (run) {
 		if (Serial.available()) {
 			const char c = static_cast<char>(Serial.read());
@@ -156,25 +215,80 @@ void hex_write() {
 			}
 		}
 	}
+	count_op(COUNT_WRITE, micros() - started);
+}
+
+uint8_t select_rom() {
+	Serial.println();
+	if (rom_count() == 1) return 0;
+
+	rom_list();
+	Serial.print(F("Image: "));
+	const uint8_t image = get_hex_value(2, 0);
+	Serial.println();
+	return image;
 }
 
 void check() {
-	Serial.println("\nChecking EEPROM contents...");
-	for (uint16_t i = 0; i < ROM_SIZE; i++) {
-		uint8_t data = pgm_read_byte(&rom[i]);
-		uint8_t readback = eeprom_read_byte(i);
-		if (readback != data) {
-			Serial.print(F("Verification failed at 0x"));
-			Serial.print(i, HEX);
-			Serial.print(F(": wrote 0x"));
-			Serial.print(data, HEX);
-			Serial.print(F(", read 0x"));
-			Serial.println(readback, HEX);
-		}
+	const uint8_t image = select_rom();
+	if (image >= rom_count()) {
+		Serial.println(F("No such image"));
+		return;
+	}
+	Serial.println(F("Checking EEPROM contents..."));
+	const unsigned long started = micros();
+	const bool match = eeprom_rom_check(image);
+	count_op(COUNT_VERIFY, micros() - started);
+	if (!match) {
+		Serial.println(F("Check failed!"));
+		return;
 	}
 	Serial.println(F("Check complete!"));
 }
 
+void blank_check() {
+	Serial.println();
+	Serial.print(F("Blank check, one character per "));
+	Serial.print(EEPROM_BLOCK_SIZE);
+	Serial.println(F(" bytes (. blank, # not blank):"));
+
+	const unsigned long started = micros();
+	uint16_t dirty = 0;
+	uint16_t first = EEPROM_SIZE;
+	for (uint32_t addr = 0; addr < EEPROM_SIZE; addr += EEPROM_BLOCK_SIZE) {
+		// 64 blocks per line
+		if (addr % (EEPROM_BLOCK_SIZE * 64) == 0) {
+			if (addr != 0) Serial.println();
+			if (addr < 0x1000) Serial.print('0');
+			if (addr < 0x100) Serial.print('0');
+			if (addr < 0x10) Serial.print('0');
+			Serial.print(addr, HEX);
+			Serial.print(F(": "));
+		}
+
+		uint16_t block_first;
+		if (eeprom_blank_check(addr, EEPROM_BLOCK_SIZE, false, &block_first) == 0) {
+			Serial.print('.');
+			continue;
+		}
+		Serial.print('#');
+		if (dirty++ == 0) first = block_first;
+	}
+	Serial.println();
+	count_op(COUNT_VERIFY, micros() - started);
+
+	if (dirty == 0) {
+		Serial.println(F("EEPROM is blank"));
+		return;
+	}
+	Serial.print(F("Not blank: "));
+	Serial.print(dirty);
+	Serial.print(F(" of "));
+	Serial.print(EEPROM_SIZE / EEPROM_BLOCK_SIZE);
+	Serial.print(F(" blocks, first byte at 0x"));
+	Serial.println(first, HEX);
+}
+
 void write_protect(const bool enable) {
 	Serial.println();
 	Serial.print(F("Write protection: "));
@@ -187,10 +301,70 @@ void write_protect(const bool enable) {
 	Serial.println(F("Done."));
 }
 
+void test_eeprom() {
+	Serial.println();
+	Serial.print(F("Quick test of sampled blocks (Y/N): "));
+	char c;
+	do {
+		while (!Serial.available()) {}
+		c = static_cast<char>(toupper(Serial.read()));
+	} while (c != 'Y' && c != 'N' && c != '\r' && c != '\n');
+	const bool quick = c == 'Y';
+	Serial.println(quick ? 'Y' : 'N');
+
+	eeprom_test(quick);
+}
+
+void start_job() {
+	Serial.println(F("Press Q to abort"));
+	job_prompt = true;
+}
+
+void write_rom() {
+	if (!eeprom_rom_write(select_rom())) {
+		Serial.println(F("No such image"));
+		return;
+	}
+	start_job();
+}
+
+void select_socket() {
+	Serial.println();
+	Serial.print(F("Socket: "));
+	eeprom_select(get_hex_value(1, 0));
+	Serial.println();
+	Serial.print(F("Reading from socket "));
+	Serial.println(eeprom_selected());
+}
+
 void loop() {
+	const bool baud_pending = protocol_poll();
+
+	// Step the running job, the prompt comes back when it is over
+	if (!job_step() && job_prompt) {
+		job_prompt = false;
+		Serial.flush();
+		print_help();
+	}
+
 	if (Serial.available()) {
 		const char c = static_cast<char>(Serial.read());
 
+		// Binary frame - see protocol.h
+		if (static_cast<uint8_t>(c) == FRAME_SOF) {
+			protocol_process_frame();
+			return;
+		}
+
+		// Until a new baud rate is confirmed, bytes outside of frames may be garbled
+		if (baud_pending) return;
+
+		// While a job runs, only Q or ESC (abort) are accepted
+		if (job_running()) {
+			if (toupper(c) == 'Q' || c == 0x1B) job_abort();
+			return;
+		}
+
 		if (c == '\r' || c == '\n') {
 			Serial.print(F("\n>"));
 			delay(100);
@@ -201,8 +375,7 @@ void loop() {
 			case 'E':
 				Serial.print(F("E"));
 				erase_eeprom();
-				Serial.flush();
-				print_help();
+				start_job();
 				break;
 
 			case 'C':
@@ -219,6 +392,13 @@ void loop() {
 				print_help();
 				break;
 
+			case 'F':
+				Serial.print(F("F"));
+				stream_eeprom();
+				Serial.flush();
+				print_help();
+				break;
+
 			case 'W':
 				Serial.print(F("W"));
 				hex_write();
@@ -227,14 +407,19 @@ void loop() {
 
 			case 'R':
 				Serial.print(F("R"));
-				eeprom_rom_write();
-				Serial.flush();
-				print_help();
+				write_rom();
+				if (!job_running()) print_help();
 				break;
 
 			case 'T':
 				Serial.print(F("T"));
-				eeprom_test();
+				test_eeprom();
+				start_job();
+				break;
+
+			case 'K':
+				Serial.print(F("K"));
+				blank_check();
 				Serial.flush();
 				print_help();
 				break;
@@ -253,6 +438,34 @@ void loop() {
 				print_help();
 				break;
 
+			case 'H':
+				Serial.println(F("H"));
+				stats_print();
+				Serial.flush();
+				print_help();
+				break;
+
+			case 'I':
+				Serial.println(F("I"));
+				counters_print();
+				Serial.flush();
+				print_help();
+				break;
+
+			case 'B':
+				Serial.println(F("B"));
+				eeprom_bench();
+				Serial.flush();
+				print_help();
+				break;
+
+			case 'N':
+				Serial.print(F("N"));
+				select_socket();
+				Serial.flush();
+				print_help();
+				break;
+
 			case '?':
 				Serial.print(F("?"));
 				print_help();
@@ -28,7 +28,8 @@
 #include <Arduino.h>
 
 /*
- * Select your chip type:
+ * Select your chip type, the parameters of each part are in chip.h:
+ * - 16 for AT28C16 (24-pin, A8 pin 23, A9 pin 22, A10 pin 19, WE pin 21, OE pin 20, CE pin 18)
  * - 64 for AT28C64
  * - 256 for AT28C256
  *            _____   _____
@@ -57,6 +58,8 @@
  * - GND -> VSS
  * - MCP23017 A0,A1,A2 -> GND (I2C address 0x20)
  *
+ * I2C clock: 400 kHz fast mode. Short wiring with 2.2k pull-ups usually allows up to 1 MHz.
+ *
  * Arduino to AT28C64:
  * - Pin 2 -> WE (Pin 27)
  * - Pin 3 -> OE (Pin 22)
@@ -100,9 +103,48 @@
 #define A13_PIN     10   // Address line A13 (AT28C256 only)
 #define A14_PIN     11   // Address line A14 (AT28C256 only)
 
+// Serial baud rate after reset, and the fallback of a failed baud rate change (see protocol.h)
+#define SERIAL_BAUD 115200
+
+// I2C clock for the MCP23017 in Hz
+#define I2C_CLOCK   400000
+
+/*
+ * Data bus backend, see bus.h. By default D0-D7 and A0-A7 go through the MCP23017. With BUS_DIRECT (set by the
+ * mega env in platformio.ini) an Arduino Mega drives them from its own ports, the MCP23017 is not needed:
+ * - Pins 22-29 (PORTA) -> D0-D7
+ * - Pins 37-30 (PORTC) -> A0-A7 (pin 37 is A0, pin 30 is A7)
+ */
+// #define BUS_DIRECT
+
 // Control pins
 #define WE_PIN      2    // Write Enable (active low)
 #define OE_PIN      3    // Output Enable (active low)
 #define CE_PIN      4    // Chip Enable (active low)
 
+/*
+ * Optional: several sockets programmed at the same time. Every socket has its own MCP23017 for D0-D7 and A0-A7,
+ * with A0-A2 of the expander set to the socket number (I2C address 0x20, 0x21, ...), and its own CE pin. WE, OE and
+ * A8-A14 are shared. A page is loaded into every socket, then all write cycles run together, so N chips take about
+ * the time of one. List the CE pins, socket 0 first. Reads use the selected socket (N command, CMD_SOCKET), verifies
+ * check all of them. RDY/BUSY of all sockets can be tied to RDY_PIN. Not available with BUS_DIRECT. The extra CE
+ * pins go on A0-A3 (14-17): 12 is RDY_PIN, 13 drives the LED and A4/A5 are the I2C bus. A CE pin that is also RDY_PIN
+ * fails the build.
+ */
+// #define SOCKET_CE_PINS  CE_PIN, 14, 15
+
+/*
+ * Optional: AT28C64 RDY/BUSY (Pin 1, open drain) -> Pin 12. The end of a write cycle is then caught by a pin change
+ * interrupt instead of polling the chip over I2C. Without it, toggle bit polling on I/O6 is used. A write cycle without
+ * an edge within tWC is polled as well. After three of them in a row the pin counts as not connected and every cycle
+ * is polled, until one ends with an edge again. Not available on the AT28C256, where pin 1 is A14.
+ */
+// #define RDY_PIN     12   // Ready/Busy (low while writing)
+
+/*
+ * Bus transaction counters and time per operation for the I command, see counters.h. They cost an increment per I2C
+ * transaction, GPIO write and data poll, comment this out to compile them out.
+ */
+#define COUNTERS
+
 #endif //EEPROM_MAIN_H
@@ -0,0 +1,184 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Tomas Vecera, tomas@vecera.dev
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <Wire.h>
+#include "mcp23017.h"
+#include "counters.h"
+
+#define MCP23017_IODIRA   0x00   // I/O direction register for port A
+#define MCP23017_IODIRB   0x01   // I/O direction register for port B
+#define MCP23017_IOCON    0x0A   // Configuration register
+#define MCP23017_GPIOA    0x12   // Port register for port A
+#define MCP23017_GPIOB    0x13   // Port register for port B
+
+// IOCON: BANK = 0 (A/B registers paired), SEQOP = 1 (byte mode, the address pointer toggles between
+// the A/B pair), everything else default. GPIOA+GPIOB bursts still work and a GPIOB write is followed
+// by GPIOA in a read without sending the register address again.
+#define MCP23017_IOCON_VALUE  0x20
+
+// Last value written to IODIRA/B and GPIOA/B of every device
+static uint8_t iodir_caches[MCP23017_DEVICES][2];
+static uint8_t gpio_caches[MCP23017_DEVICES][2];
+
+// Selected device, its I2C address and register cache
+static uint8_t address = MCP23017_ADDRESS;
+static uint8_t *iodir_cache = iodir_caches[0];
+static uint8_t *gpio_cache = gpio_caches[0];
+
+/**
+ * @brief Write consecutive MCP23017 registers in one transaction.
+ * @param reg First register
+ * @param a Value for the first register
+ * @param b Value for the second register
+ * @param count Number of registers to write (1 or 2)
+ * @return Wire.endTransmission() status, 0 on success
+ */
+static uint8_t write_registers(const uint8_t reg, const uint8_t a, const uint8_t b, const uint8_t count) {
+	Wire.beginTransmission(address);
+	Wire.write(reg);
+	Wire.write(a);
+	if (count > 1) Wire.write(b);
+	count_i2c(2 + count);
+	return Wire.endTransmission();
+}
+
+/**
+ * @brief Initialize the MCP23017 devices 0 to count - 1. Sets the TWI clock, selects IOCON.BANK = 0 in byte mode,
+ * so the address pointer toggles between GPIOA and GPIOB, and loads the register cache. Device 0 is selected.
+ * @param clock I2C clock in Hz
+ * @param count Number of devices, up to MCP23017_DEVICES
+ * @return True if every MCP23017 acknowledged, false otherwise
+ */
+bool mcp_init(const uint32_t clock, const uint8_t count) {
+	Wire.begin();
+	Wire.setClock(clock);
+
+	bool ok = true;
+	for (uint8_t device = count; device-- > 0;) {
+		mcp_select(device);
+		if (write_registers(MCP23017_IOCON, MCP23017_IOCON_VALUE, 0, 1) != 0) {
+			ok = false;
+			continue;
+		}
+
+		// Port A (data) INPUT, port B (A0-A7) OUTPUT, both latches cleared
+		iodir_cache[MCP23017_PORTA] = 0xFF;
+		iodir_cache[MCP23017_PORTB] = 0x00;
+		gpio_cache[MCP23017_PORTA] = 0x00;
+		gpio_cache[MCP23017_PORTB] = 0x00;
+		write_registers(MCP23017_GPIOA, 0x00, 0x00, 2);
+		if (write_registers(MCP23017_IODIRA, 0xFF, 0x00, 2) != 0) ok = false;
+	}
+	return ok;
+}
+
+/**
+ * @brief Select the MCP23017 used by the other functions. Every device has its own register cache.
+ * @param device Device number (I2C address - MCP23017_ADDRESS)
+ */
+void mcp_select(const uint8_t device) {
+	address = MCP23017_ADDRESS + device;
+	iodir_cache = iodir_caches[device];
+	gpio_cache = gpio_caches[device];
+}
+
+/**
+ * @brief Set the I/O direction for a given MCP23017 port. Skipped if the port is already in that mode.
+ * @param port Port number (PORTA = 0 or PORTB = 1)
+ * @param mode INPUT or OUTPUT
+ */
+void mcp_set_port_mode(const uint8_t port, const uint8_t mode) {
+	const uint8_t value = mode == INPUT ? 0xFF : 0x00; // All pins INPUT or OUTPUT
+	if (iodir_cache[port] == value) return;
+
+	iodir_cache[port] = value;
+	write_registers(MCP23017_IODIRA + port, value, 0, 1);
+}
+
+/**
+ * @brief Write a GPIO register of the MCP23017. Skipped if the value did not change.
+ * @param port Port number (PORTA = 0 or PORTB = 1)
+ * @param value Value to write
+ */
+void mcp_write_port(const uint8_t port, const uint8_t value) {
+	if (gpio_cache[port] == value) return;
+
+	gpio_cache[port] = value;
+	write_registers(MCP23017_GPIOA + port, value, 0, 1);
+}
+
+/**
+ * @brief Write GPIOA and GPIOB of the MCP23017 in one transaction. Only registers that changed are sent.
+ * @param porta Value for GPIOA
+ * @param portb Value for GPIOB
+ */
+void mcp_write_ports(const uint8_t porta, const uint8_t portb) {
+	if (gpio_cache[MCP23017_PORTA] == porta) {
+		mcp_write_port(MCP23017_PORTB, portb);
+		return;
+	}
+	if (gpio_cache[MCP23017_PORTB] == portb) {
+		mcp_write_port(MCP23017_PORTA, porta);
+		return;
+	}
+
+	gpio_cache[MCP23017_PORTA] = porta;
+	gpio_cache[MCP23017_PORTB] = portb;
+	write_registers(MCP23017_GPIOA, porta, portb, 2);
+}
+
+/**
+ * @brief Read a GPIO register of the MCP23017.
+ * @param port Port number (PORTA = 0 or PORTB = 1)
+ * @return Byte containing all 8 pins
+ */
+uint8_t mcp_read_port(const uint8_t port) {
+	count_i2c(2); // Register address
+	count_i2c(2); // One byte read
+	Wire.beginTransmission(address);
+	Wire.write(MCP23017_GPIOA + port);
+	Wire.endTransmission();
+	Wire.requestFrom(address, static_cast<uint8_t>(1));
+	return Wire.read();
+}
+
+/**
+ * @brief Write a GPIO register and read the paired one (GPIOB -> GPIOA or back) in one transaction,
+ * using a repeated start. The address pointer toggles to the paired register after the write.
+ * @param port Port number to write (PORTA = 0 or PORTB = 1)
+ * @param value Value to write
+ * @return Byte containing all 8 pins of the other port
+ */
+uint8_t mcp_write_port_read(const uint8_t port, const uint8_t value) {
+	if (gpio_cache[port] == value) return mcp_read_port(port ^ 1);
+
+	gpio_cache[port] = value;
+	count_i2c(5);
+	Wire.beginTransmission(address);
+	Wire.write(MCP23017_GPIOA + port);
+	Wire.write(value);
+	Wire.endTransmission(false);
+	Wire.requestFrom(address, static_cast<uint8_t>(1));
+	return Wire.read();
+}
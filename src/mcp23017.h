@@ -0,0 +1,87 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Tomas Vecera, tomas@vecera.dev
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef EEPROM_MCP23017_H
+#define EEPROM_MCP23017_H
+
+#include <Arduino.h>
+
+#define MCP23017_ADDRESS  0x20   // I2C address of device 0 (A0-A2 grounded), device n is at MCP23017_ADDRESS + n
+#define MCP23017_DEVICES  8      // Devices on one I2C bus, set by A0-A2
+#define MCP23017_PORTA    0
+#define MCP23017_PORTB    1
+
+/**
+ * @brief Initialize the MCP23017 devices 0 to count - 1. Sets the TWI clock, selects IOCON.BANK = 0 in byte mode,
+ * so the address pointer toggles between GPIOA and GPIOB, and loads the register cache. Device 0 is selected.
+ * @param clock I2C clock in Hz
+ * @param count Number of devices, up to MCP23017_DEVICES
+ * @return True if every MCP23017 acknowledged, false otherwise
+ */
+bool mcp_init(uint32_t clock, uint8_t count);
+
+/**
+ * @brief Select the MCP23017 used by the other functions. Every device has its own register cache.
+ * @param device Device number (I2C address - MCP23017_ADDRESS)
+ */
+void mcp_select(uint8_t device);
+
+/**
+ * @brief Set the I/O direction for a given MCP23017 port. Skipped if the port is already in that mode.
+ * @param port Port number (PORTA = 0 or PORTB = 1)
+ * @param mode INPUT or OUTPUT
+ */
+void mcp_set_port_mode(uint8_t port, uint8_t mode);
+
+/**
+ * @brief Write a GPIO register of the MCP23017. Skipped if the value did not change.
+ * @param port Port number (PORTA = 0 or PORTB = 1)
+ * @param value Value to write
+ */
+void mcp_write_port(uint8_t port, uint8_t value);
+
+/**
+ * @brief Write GPIOA and GPIOB of the MCP23017 in one transaction. Only registers that changed are sent.
+ * @param porta Value for GPIOA
+ * @param portb Value for GPIOB
+ */
+void mcp_write_ports(uint8_t porta, uint8_t portb);
+
+/**
+ * @brief Read a GPIO register of the MCP23017.
+ * @param port Port number (PORTA = 0 or PORTB = 1)
+ * @return Byte containing all 8 pins
+ */
+uint8_t mcp_read_port(uint8_t port);
+
+/**
+ * @brief Write a GPIO register and read the paired one (GPIOB -> GPIOA or back) in one transaction,
+ * using a repeated start. The address pointer toggles to the paired register after the write.
+ * @param port Port number to write (PORTA = 0 or PORTB = 1)
+ * @param value Value to write
+ * @return Byte containing all 8 pins of the other port
+ */
+uint8_t mcp_write_port_read(uint8_t port, uint8_t value);
+
+#endif //EEPROM_MCP23017_H
@@ -0,0 +1,95 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Tomas Vecera, tomas@vecera.dev
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "main.h"
+#include "progress.h"
+#include "protocol.h"
+
+// The operation being reported
+static struct {
+	char operation;
+	uint16_t total;
+	unsigned long start_time;
+	unsigned long last_report;
+} progress;
+
+/**
+ * @brief Send one report, a CMD_PROGRESS frame to the host or a dot on the text console.
+ */
+static void progress_report(const uint16_t address, const uint16_t done, const uint32_t errors) {
+	progress.last_report = millis();
+	if (!protocol_host()) {
+		Serial.print(F("."));
+		return;
+	}
+
+	const unsigned long elapsed = progress.last_report - progress.start_time;
+	uint32_t rate = elapsed != 0 ? static_cast<uint32_t>(done) * 1000 / elapsed : 0;
+	if (rate > UINT16_MAX) rate = UINT16_MAX;
+
+	const uint8_t report[] = {
+		static_cast<uint8_t>(progress.operation),
+		static_cast<uint8_t>(address & 0xFF), static_cast<uint8_t>(address >> 8),
+		static_cast<uint8_t>(done & 0xFF), static_cast<uint8_t>(done >> 8),
+		static_cast<uint8_t>(progress.total & 0xFF), static_cast<uint8_t>(progress.total >> 8),
+		static_cast<uint8_t>(rate & 0xFF), static_cast<uint8_t>(rate >> 8),
+		static_cast<uint8_t>(errors & 0xFF), static_cast<uint8_t>(errors >> 8),
+		static_cast<uint8_t>(errors >> 16), static_cast<uint8_t>(errors >> 24)
+	};
+	protocol_notify(CMD_PROGRESS, report, sizeof(report));
+}
+
+/**
+ * @brief Start reporting a new operation.
+ * @param operation Operation code, the letter of the text command ('E', 'R', 'T')
+ * @param total Number of bytes the operation will process
+ */
+void progress_start(const char operation, const uint16_t total) {
+	progress.operation = operation;
+	progress.total = total;
+	progress.start_time = millis();
+	progress.last_report = progress.start_time;
+}
+
+/**
+ * @brief Report the progress if PROGRESS_INTERVAL has passed since the last report.
+ * @param address Next EEPROM address to process
+ * @param done Bytes processed so far
+ * @param errors Errors so far
+ */
+void progress_update(const uint16_t address, const uint16_t done, const uint32_t errors) {
+	if (millis() - progress.last_report >= PROGRESS_INTERVAL) {
+		progress_report(address, done, errors);
+	}
+}
+
+/**
+ * @brief Send the final report of the operation, regardless of the interval.
+ * @param address Next EEPROM address to process
+ * @param done Bytes processed, less than the total if the operation was aborted
+ * @param errors Errors of the operation
+ */
+void progress_end(const uint16_t address, const uint16_t done, const uint32_t errors) {
+	progress_report(address, done, errors);
+}
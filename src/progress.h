@@ -0,0 +1,60 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Tomas Vecera, tomas@vecera.dev
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef EEPROM_PROGRESS_H
+#define EEPROM_PROGRESS_H
+
+#include <Arduino.h>
+
+/*
+ * Progress of a long operation, reported at most every PROGRESS_INTERVAL ms. Once a host has sent a valid binary
+ * frame the reports are CMD_PROGRESS frames (see protocol.h), otherwise a dot is printed for each one. A report
+ * is a few bytes in the UART transmit buffer, so it does not hold up the operation.
+ */
+#define PROGRESS_INTERVAL   250   // ms between two reports
+
+/**
+ * @brief Start reporting a new operation.
+ * @param operation Operation code, the letter of the text command ('E', 'R', 'T')
+ * @param total Number of bytes the operation will process
+ */
+void progress_start(char operation, uint16_t total);
+
+/**
+ * @brief Report the progress if PROGRESS_INTERVAL has passed since the last report.
+ * @param address Next EEPROM address to process
+ * @param done Bytes processed so far
+ * @param errors Errors so far
+ */
+void progress_update(uint16_t address, uint16_t done, uint32_t errors);
+
+/**
+ * @brief Send the final report of the operation, regardless of the interval.
+ * @param address Next EEPROM address to process
+ * @param done Bytes processed, less than the total if the operation was aborted
+ * @param errors Errors of the operation
+ */
+void progress_end(uint16_t address, uint16_t done, uint32_t errors);
+
+#endif //EEPROM_PROGRESS_H
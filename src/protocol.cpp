@@ -0,0 +1,751 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Tomas Vecera, tomas@vecera.dev
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "main.h"
+#include "at28c.h"
+#include "counters.h"
+#include "crc.h"
+#include "job.h"
+#include "protocol.h"
+
+#define FRAME_TIMEOUT  50   // ms to wait for the next byte of a frame
+#define RLE_MAX_RUN   257   // Two bytes and a count of 255 further copies
+
+static uint8_t payload[PROTOCOL_MAX_PAYLOAD];
+static uint16_t tx_crc;
+
+// Baud rate change that has not been confirmed by a valid frame yet
+static bool baud_pending = false;
+static unsigned long baud_since;
+
+// A valid frame has been received, progress goes out as CMD_PROGRESS frames (see progress.h)
+static bool host = false;
+
+/**
+ * @brief Read one byte of a frame.
+ * @param data Received byte
+ * @return True if a byte was received before FRAME_TIMEOUT, false otherwise
+ */
+static bool frame_read(uint8_t *data) {
+	const unsigned long start = millis();
+	while (!Serial.available()) {
+		if (millis() - start > FRAME_TIMEOUT) return false;
+	}
+	*data = Serial.read();
+	return true;
+}
+
+/**
+ * @brief Send bytes of a response frame and add them to the CRC.
+ * @param buf Data to send
+ * @param len Number of bytes
+ */
+static void frame_write(const uint8_t *buf, const uint16_t len) {
+	for (uint16_t i = 0; i < len; i++) {
+		tx_crc = crc16_update(tx_crc, buf[i]);
+	}
+	Serial.write(buf, len);
+}
+
+/**
+ * @brief Start a response frame. Exactly len bytes, including the status byte, have to follow.
+ * @param cmd Command being answered
+ * @param seq Sequence number of the request
+ * @param status Status code
+ * @param len Payload length including the status byte
+ */
+static void frame_begin(const uint8_t cmd, const uint8_t seq, const uint8_t status, const uint16_t len) {
+	const uint8_t header[] = {cmd, seq, static_cast<uint8_t>(len & 0xFF), static_cast<uint8_t>(len >> 8), status};
+	Serial.write(FRAME_SOF);
+	tx_crc = CRC16_INIT;
+	frame_write(header, sizeof(header));
+}
+
+/**
+ * @brief Finish a response frame by sending its CRC.
+ */
+static void frame_end() {
+	Serial.write(tx_crc & 0xFF);
+	Serial.write(tx_crc >> 8);
+}
+
+/**
+ * @brief Send a response frame with a status code only.
+ */
+static void frame_status(const uint8_t cmd, const uint8_t seq, const uint8_t status) {
+	frame_begin(cmd, seq, status, 1);
+	frame_end();
+}
+
+/**
+ * @brief Check that an address range lies inside the EEPROM.
+ */
+static bool range_valid(const uint16_t address, const uint16_t len) {
+	return address < EEPROM_SIZE && len <= EEPROM_SIZE - address;
+}
+
+/**
+ * @brief Get a 16 bit little endian value from the payload.
+ */
+static uint16_t payload_word(const uint8_t offset) {
+	return payload[offset] | (payload[offset + 1] << 8);
+}
+
+/**
+ * @brief CMD_STATUS - report protocol version and chip geometry.
+ */
+static void cmd_status(const uint8_t seq) {
+	const uint8_t info[] = {
+		PROTOCOL_VERSION,
+		EEPROM_SIZE & 0xFF, EEPROM_SIZE >> 8,
+		EEPROM_PAGE_SIZE,
+		PROTOCOL_MAX_PAYLOAD,
+		EEPROM_SOCKETS
+	};
+	frame_begin(CMD_STATUS, seq, STATUS_OK, 1 + sizeof(info));
+	frame_write(info, sizeof(info));
+	frame_end();
+}
+
+/**
+ * @brief CMD_READ - stream an address range. The data is sent while it is read, so the frame is not
+ * limited by RAM and the UART transmit buffer provides the back-pressure.
+ */
+static void cmd_read(const uint8_t seq, const uint16_t len) {
+	if (len != 4) {
+		frame_status(CMD_READ, seq, STATUS_BAD_LENGTH);
+		return;
+	}
+	const uint16_t address = payload_word(0);
+	const uint16_t count = payload_word(2);
+	if (!range_valid(address, count)) {
+		frame_status(CMD_READ, seq, STATUS_BAD_ADDRESS);
+		return;
+	}
+
+	frame_begin(CMD_READ, seq, STATUS_OK, 1 + count);
+	uint8_t buf[EEPROM_BLOCK_SIZE];
+	for (uint16_t offset = 0; offset < count; offset += sizeof(buf)) {
+		const uint16_t chunk = min(count - offset, sizeof(buf));
+		eeprom_read_block(address + offset, buf, chunk);
+		frame_write(buf, chunk);
+	}
+	frame_end();
+}
+
+/**
+ * @brief Sequential reader of an EEPROM range, buffered in blocks.
+ */
+struct range_reader {
+	uint16_t address;               // EEPROM address of buf[0]
+	uint16_t end;                   // First address after the range
+	uint8_t len;                    // Valid bytes in buf
+	uint8_t pos;                    // Next byte in buf
+	uint8_t buf[EEPROM_BLOCK_SIZE];
+};
+
+/**
+ * @brief Get the next byte of the range without consuming it. The next block is read when the buffer is used up.
+ * @param reader Range reader
+ * @param data Next byte
+ * @return True if a byte was available, false at the end of the range
+ */
+static bool reader_peek(range_reader *reader, uint8_t *data) {
+	if (reader->pos == reader->len) {
+		reader->address += reader->len;
+		if (reader->address >= reader->end) return false;
+
+		reader->len = min(reader->end - reader->address, sizeof(reader->buf));
+		reader->pos = 0;
+		eeprom_read_block(reader->address, reader->buf, reader->len);
+	}
+	*data = reader->buf[reader->pos];
+	return true;
+}
+
+/**
+ * @brief Run-length encode the next part of a range, as much as fits into RLE_BUFFER encoded bytes.
+ * @param reader Range reader, advanced past the encoded bytes
+ * @param out Buffer of RLE_BUFFER bytes for the encoded data
+ * @param covered Set to the number of EEPROM bytes encoded
+ * @return Number of encoded bytes
+ */
+static uint8_t rle_encode(range_reader *reader, uint8_t *out, uint16_t *covered) {
+	uint8_t out_len = 0;
+	uint8_t value;
+	*covered = 0;
+
+	// Every run is at most 3 encoded bytes, stop when the next one might not fit
+	while (out_len + 3 <= RLE_BUFFER && reader_peek(reader, &value)) {
+		uint16_t run = 0;
+		uint8_t next;
+		while (run < RLE_MAX_RUN && reader_peek(reader, &next) && next == value) {
+			reader->pos++;
+			run++;
+		}
+
+		out[out_len++] = value;
+		if (run >= 2) {
+			out[out_len++] = value;
+			out[out_len++] = run - 2;
+		}
+		*covered += run;
+	}
+	return out_len;
+}
+
+/**
+ * @brief Send a run-length encoded response: status, bytes covered (2) and the encoded data.
+ */
+static void frame_rle(const uint8_t cmd, const uint8_t seq, const uint16_t covered, const uint8_t *out,
+		const uint8_t out_len) {
+	const uint8_t header[] = {static_cast<uint8_t>(covered & 0xFF), static_cast<uint8_t>(covered >> 8)};
+	frame_begin(cmd, seq, STATUS_OK, 1 + sizeof(header) + out_len);
+	frame_write(header, sizeof(header));
+	frame_write(out, out_len);
+	frame_end();
+}
+
+/**
+ * @brief CMD_READ_RLE - read an address range run-length encoded, so blank or filled areas cost a few bytes
+ * on the serial line. The response covers as much of the range as fits into RLE_BUFFER.
+ */
+static void cmd_read_rle(const uint8_t seq, const uint16_t len) {
+	if (len != 4) {
+		frame_status(CMD_READ_RLE, seq, STATUS_BAD_LENGTH);
+		return;
+	}
+	const uint16_t address = payload_word(0);
+	const uint16_t count = payload_word(2);
+	if (!range_valid(address, count)) {
+		frame_status(CMD_READ_RLE, seq, STATUS_BAD_ADDRESS);
+		return;
+	}
+
+	range_reader reader = {address, static_cast<uint16_t>(address + count), 0, 0, {}};
+	uint8_t out[RLE_BUFFER];
+	uint16_t covered;
+	const uint8_t out_len = rle_encode(&reader, out, &covered);
+	frame_rle(CMD_READ_RLE, seq, covered, out, out_len);
+}
+
+/**
+ * @brief CMD_DUMP - stream a whole address range as back-to-back CMD_READ_RLE style frames without waiting for
+ * the host in between. Serial.write() blocks while the transmit buffer is full, so the UART paces the dump.
+ */
+static void cmd_dump(const uint8_t seq, const uint16_t len) {
+	if (len != 4) {
+		frame_status(CMD_DUMP, seq, STATUS_BAD_LENGTH);
+		return;
+	}
+	const uint16_t address = payload_word(0);
+	uint16_t remaining = payload_word(2);
+	if (!range_valid(address, remaining)) {
+		frame_status(CMD_DUMP, seq, STATUS_BAD_ADDRESS);
+		return;
+	}
+
+	range_reader reader = {address, static_cast<uint16_t>(address + remaining), 0, 0, {}};
+	uint8_t out[RLE_BUFFER];
+	do {
+		uint16_t covered;
+		const uint8_t out_len = rle_encode(&reader, out, &covered);
+		frame_rle(CMD_DUMP, seq, covered, out, out_len);
+		remaining -= covered;
+	} while (remaining);
+}
+
+/**
+ * @brief CMD_PAGE_CRC - stream the CRC16 of every page in an address range, so the host can find changed
+ * pages without reading the whole chip. The last page may be partial.
+ */
+static void cmd_page_crc(const uint8_t seq, const uint16_t len) {
+	if (len != 4) {
+		frame_status(CMD_PAGE_CRC, seq, STATUS_BAD_LENGTH);
+		return;
+	}
+	const uint16_t address = payload_word(0);
+	const uint16_t count = payload_word(2);
+	if (!range_valid(address, count) || (address & (EEPROM_PAGE_SIZE - 1)) != 0) {
+		frame_status(CMD_PAGE_CRC, seq, STATUS_BAD_ADDRESS);
+		return;
+	}
+
+	const uint16_t pages = (count + EEPROM_PAGE_SIZE - 1) / EEPROM_PAGE_SIZE;
+	frame_begin(CMD_PAGE_CRC, seq, STATUS_OK, 1 + pages * 2);
+	uint8_t buf[EEPROM_PAGE_SIZE];
+	for (uint16_t offset = 0; offset < count; offset += sizeof(buf)) {
+		const uint16_t chunk = min(count - offset, sizeof(buf));
+		eeprom_read_block(address + offset, buf, chunk);
+
+		uint16_t crc = CRC16_INIT;
+		for (uint16_t i = 0; i < chunk; i++) {
+			crc = crc16_update(crc, buf[i]);
+		}
+		const uint8_t result[] = {static_cast<uint8_t>(crc & 0xFF), static_cast<uint8_t>(crc >> 8)};
+		frame_write(result, sizeof(result));
+	}
+	frame_end();
+}
+
+/**
+ * @brief CMD_CRC32 - compute one CRC32 over an address range, for a quick pass/fail check of a programmed chip.
+ */
+static void cmd_crc32(const uint8_t seq, const uint16_t len) {
+	if (len != 4) {
+		frame_status(CMD_CRC32, seq, STATUS_BAD_LENGTH);
+		return;
+	}
+	const uint16_t address = payload_word(0);
+	const uint16_t count = payload_word(2);
+	if (!range_valid(address, count)) {
+		frame_status(CMD_CRC32, seq, STATUS_BAD_ADDRESS);
+		return;
+	}
+
+	const uint32_t crc = eeprom_crc32(address, count);
+
+	const uint8_t result[] = {
+		static_cast<uint8_t>(crc & 0xFF), static_cast<uint8_t>(crc >> 8),
+		static_cast<uint8_t>(crc >> 16), static_cast<uint8_t>(crc >> 24)
+	};
+	frame_begin(CMD_CRC32, seq, STATUS_OK, 1 + sizeof(result));
+	frame_write(result, sizeof(result));
+	frame_end();
+}
+
+/**
+ * @brief CMD_BLANK_CHECK - check an address range for bytes other than 0xFF.
+ */
+static void cmd_blank_check(const uint8_t seq, const uint16_t len) {
+	if (len != 5) {
+		frame_status(CMD_BLANK_CHECK, seq, STATUS_BAD_LENGTH);
+		return;
+	}
+	const uint16_t address = payload_word(0);
+	const uint16_t count = payload_word(2);
+	if (!range_valid(address, count)) {
+		frame_status(CMD_BLANK_CHECK, seq, STATUS_BAD_ADDRESS);
+		return;
+	}
+
+	uint16_t first;
+	const uint16_t dirty = eeprom_blank_check(address, count, payload[4] & BLANK_FULL, &first);
+
+	const uint8_t result[] = {
+		static_cast<uint8_t>(dirty & 0xFF), static_cast<uint8_t>(dirty >> 8),
+		static_cast<uint8_t>(first & 0xFF), static_cast<uint8_t>(first >> 8)
+	};
+	frame_begin(CMD_BLANK_CHECK, seq, STATUS_OK, 1 + sizeof(result));
+	frame_write(result, sizeof(result));
+	frame_end();
+}
+
+/**
+ * @brief Compare payload data with the EEPROM of every socket.
+ * @param address EEPROM address of the first byte
+ * @param data Expected data
+ * @param len Number of bytes
+ * @param first First address that does not match in any socket, untouched if all match
+ * @return Number of bytes that do not match, summed over all sockets
+ */
+static uint16_t compare(const uint16_t address, const uint8_t *data, const uint16_t len, uint16_t *first) {
+	uint8_t buf[PROTOCOL_MAX_PAYLOAD];
+	uint16_t mismatches = 0;
+	uint16_t lowest = len;
+	const uint8_t selected = eeprom_selected();
+
+	for (uint8_t socket = 0; socket < EEPROM_SOCKETS; socket++) {
+		eeprom_select(socket);
+		eeprom_read_block(address, buf, len);
+		for (uint16_t i = 0; i < len; i++) {
+			if (buf[i] == data[i]) continue;
+			if (i < lowest) lowest = i;
+			mismatches++;
+		}
+	}
+	eeprom_select(selected);
+
+	if (mismatches != 0) *first = address + lowest;
+	return mismatches;
+}
+
+/**
+ * @brief Get the decoded length of run-length encoded data.
+ * @param data Encoded data
+ * @param len Number of encoded bytes
+ * @param decoded Decoded length
+ * @return True if the data is complete, false if it ends inside a run
+ */
+static bool rle_length(const uint8_t *data, const uint16_t len, uint32_t *decoded) {
+	*decoded = 0;
+	for (uint16_t i = 0; i < len;) {
+		if (i + 1 < len && data[i + 1] == data[i]) {
+			if (i + 2 >= len) return false;
+			*decoded += 2 + data[i + 2];
+			i += 3;
+		} else {
+			*decoded += 1;
+			i++;
+		}
+	}
+	return true;
+}
+
+/**
+ * @brief Write one page (or the part of it collected), skipping bytes that already match, and verify it.
+ * @param address EEPROM address of the first byte
+ * @param data Page data
+ * @param len Number of bytes, must not cross the page boundary
+ * @param mismatches Incremented by the number of bytes that do not match
+ * @param first First address that does not match, set on the first mismatch only
+ */
+static void write_verify_page(const uint16_t address, const uint8_t *data, const uint8_t len, uint16_t *mismatches,
+                              uint16_t *first) {
+	eeprom_update_page(address, data, len, nullptr);
+
+	uint16_t page_first = 0;
+	const uint16_t page_mismatches = compare(address, data, len, &page_first);
+	if (page_mismatches != 0 && *mismatches == 0) *first = page_first;
+	*mismatches += page_mismatches;
+}
+
+/**
+ * @brief CMD_WRITE_RLE - decode run-length encoded data straight into a page buffer and write it page by page,
+ * so padding and tables cost a few bytes on the serial line. Every page is verified. The response carries the
+ * decoded length, so the host can tell that the frame decoded to the bytes it meant.
+ */
+static void cmd_write_rle(const uint8_t seq, const uint16_t len) {
+	if (len < 2) {
+		frame_status(CMD_WRITE_RLE, seq, STATUS_BAD_LENGTH);
+		return;
+	}
+	const uint16_t address = payload_word(0);
+	const uint8_t *data = &payload[2];
+	const uint16_t count = len - 2;
+
+	// Check the whole frame before the first write
+	uint32_t decoded;
+	if (!rle_length(data, count, &decoded)) {
+		frame_status(CMD_WRITE_RLE, seq, STATUS_BAD_LENGTH);
+		return;
+	}
+	if (address >= EEPROM_SIZE || decoded > EEPROM_SIZE - address) {
+		frame_status(CMD_WRITE_RLE, seq, STATUS_BAD_ADDRESS);
+		return;
+	}
+
+	uint8_t page[EEPROM_PAGE_SIZE];
+	uint16_t page_address = address;
+	uint8_t page_len = 0;
+	uint8_t page_room = EEPROM_PAGE_SIZE - (address & (EEPROM_PAGE_SIZE - 1));
+	uint16_t mismatches = 0;
+	uint16_t first = 0;
+
+	for (uint16_t i = 0; i < count;) {
+		const uint8_t value = data[i];
+		uint16_t run = 1;
+		if (i + 1 < count && data[i + 1] == value) {
+			run = 2 + data[i + 2];
+			i += 3;
+		} else {
+			i++;
+		}
+
+		while (run-- > 0) {
+			page[page_len++] = value;
+			if (page_len == page_room) {
+				write_verify_page(page_address, page, page_len, &mismatches, &first);
+				page_address += page_len;
+				page_len = 0;
+				page_room = EEPROM_PAGE_SIZE;
+			}
+		}
+	}
+	if (page_len != 0) {
+		write_verify_page(page_address, page, page_len, &mismatches, &first);
+	}
+
+	const uint8_t result[] = {
+		static_cast<uint8_t>(mismatches & 0xFF), static_cast<uint8_t>(mismatches >> 8),
+		static_cast<uint8_t>(first & 0xFF), static_cast<uint8_t>(first >> 8),
+		static_cast<uint8_t>(decoded & 0xFF), static_cast<uint8_t>(decoded >> 8)
+	};
+	frame_begin(CMD_WRITE_RLE, seq, mismatches == 0 ? STATUS_OK : STATUS_VERIFY_FAILED, 1 + sizeof(result));
+	frame_write(result, sizeof(result));
+	frame_end();
+}
+
+/**
+ * @brief Restart the UART at a new baud rate. Bytes still in the receive buffer are dropped.
+ * @param baud Baud rate
+ */
+static void set_baud(const uint32_t baud) {
+	Serial.end();
+	Serial.begin(baud);
+}
+
+/**
+ * @brief CMD_BAUD - switch to a new baud rate. The acknowledge is sent at the old rate, then the rate is pending
+ * until the next valid frame, see protocol_poll().
+ */
+static void cmd_baud(const uint8_t seq, const uint16_t len) {
+	if (len != 4) {
+		frame_status(CMD_BAUD, seq, STATUS_BAD_LENGTH);
+		return;
+	}
+	const uint32_t baud = payload_word(0) | static_cast<uint32_t>(payload_word(2)) << 16;
+	if (baud < BAUD_MIN || baud > BAUD_MAX) {
+		frame_status(CMD_BAUD, seq, STATUS_BAD_VALUE);
+		return;
+	}
+
+	frame_status(CMD_BAUD, seq, STATUS_OK);
+	Serial.flush();
+	set_baud(baud);
+	baud_pending = true;
+	baud_since = millis();
+}
+
+/**
+ * @brief Fall back to SERIAL_BAUD if a baud rate change was not confirmed in time. Call it from the main loop.
+ * @return True while a baud rate change waits for its confirmation
+ */
+bool protocol_poll() {
+	if (baud_pending && millis() - baud_since > BAUD_CONFIRM) {
+		baud_pending = false;
+		set_baud(SERIAL_BAUD);
+	}
+	return baud_pending;
+}
+
+/**
+ * @brief Check whether a host talks to the programmer, i.e. a valid binary frame has been received since reset.
+ * @return True if a host has sent a valid frame
+ */
+bool protocol_host() {
+	return host;
+}
+
+/**
+ * @brief Send an unsolicited frame with SEQ 0 and status STATUS_OK.
+ * @param cmd Command code
+ * @param data Payload after the status byte
+ * @param len Number of bytes
+ */
+void protocol_notify(const uint8_t cmd, const uint8_t *data, const uint8_t len) {
+	frame_begin(cmd, 0, STATUS_OK, 1 + len);
+	frame_write(data, len);
+	frame_end();
+}
+
+/**
+ * @brief CMD_WRITE and CMD_VERIFY - write (optional) and verify data at an address.
+ */
+static void cmd_write_verify(const uint8_t cmd, const uint8_t seq, const uint16_t len) {
+	if (len < 2) {
+		frame_status(cmd, seq, STATUS_BAD_LENGTH);
+		return;
+	}
+	const uint16_t address = payload_word(0);
+	const uint16_t count = len - 2;
+	const uint8_t *data = &payload[2];
+	if (!range_valid(address, count)) {
+		frame_status(cmd, seq, STATUS_BAD_ADDRESS);
+		return;
+	}
+
+	if (cmd == CMD_WRITE) {
+		for (uint16_t offset = 0; offset < count;) {
+			offset += eeprom_update_page(address + offset, &data[offset], count - offset, nullptr);
+		}
+	}
+
+	uint16_t first = 0;
+	const uint16_t mismatches = compare(address, data, count, &first);
+	const uint8_t result[] = {
+		static_cast<uint8_t>(mismatches & 0xFF), static_cast<uint8_t>(mismatches >> 8),
+		static_cast<uint8_t>(first & 0xFF), static_cast<uint8_t>(first >> 8)
+	};
+	frame_begin(cmd, seq, mismatches == 0 ? STATUS_OK : STATUS_VERIFY_FAILED, 1 + sizeof(result));
+	frame_write(result, sizeof(result));
+	frame_end();
+}
+
+/**
+ * @brief CMD_SOCKET - select the socket for the read commands.
+ */
+static void cmd_socket(const uint8_t seq, const uint16_t len) {
+	if (len != 1) {
+		frame_status(CMD_SOCKET, seq, STATUS_BAD_LENGTH);
+		return;
+	}
+	if (payload[0] >= EEPROM_SOCKETS) {
+		frame_status(CMD_SOCKET, seq, STATUS_BAD_VALUE);
+		return;
+	}
+
+	eeprom_select(payload[0]);
+	frame_status(CMD_SOCKET, seq, STATUS_OK);
+}
+
+/**
+ * @brief Check whether a command changes the EEPROM, the selected socket or the baud rate, see STATUS_BUSY.
+ */
+static bool command_changes_state(const uint8_t cmd) {
+	switch (cmd) {
+		case CMD_WRITE:
+		case CMD_WRITE_RLE:
+		case CMD_BAUD:
+		case CMD_SOCKET:
+			return true;
+
+		default:
+			return false;
+	}
+}
+
+/**
+ * @brief Get the counter of a command, see counters.h.
+ */
+static uint8_t command_counter(const uint8_t cmd) {
+	switch (cmd) {
+		case CMD_READ:
+		case CMD_READ_RLE:
+		case CMD_DUMP:
+			return COUNT_DUMP;
+
+		case CMD_WRITE:
+		case CMD_WRITE_RLE:
+			return COUNT_WRITE;
+
+		case CMD_VERIFY:
+		case CMD_PAGE_CRC:
+		case CMD_CRC32:
+		case CMD_BLANK_CHECK:
+			return COUNT_VERIFY;
+
+		default:
+			return COUNT_NONE;
+	}
+}
+
+/**
+ * @brief Receive and execute one binary frame. Call it after FRAME_SOF was read from Serial.
+ * Incomplete frames are dropped after a short timeout.
+ */
+void protocol_process_frame() {
+	uint8_t header[4];
+	for (uint8_t i = 0; i < sizeof(header); i++) {
+		if (!frame_read(&header[i])) return;
+	}
+	const uint8_t cmd = header[0];
+	const uint8_t seq = header[1];
+	const uint16_t len = header[2] | (header[3] << 8);
+
+	uint16_t crc = CRC16_INIT;
+	for (uint8_t i = 0; i < sizeof(header); i++) {
+		crc = crc16_update(crc, header[i]);
+	}
+
+	// Oversized payload is still received to keep the stream in sync, but not stored
+	for (uint16_t i = 0; i < len; i++) {
+		uint8_t data;
+		if (!frame_read(&data)) return;
+		if (i < sizeof(payload)) payload[i] = data;
+		crc = crc16_update(crc, data);
+	}
+
+	uint8_t crc_lo, crc_hi;
+	if (!frame_read(&crc_lo) || !frame_read(&crc_hi)) return;
+	if ((crc_lo | (crc_hi << 8)) != crc) {
+		frame_status(cmd, seq, STATUS_BAD_CRC);
+		return;
+	}
+
+	// A valid frame confirms the baud rate
+	baud_pending = false;
+	host = true;
+	if (len > sizeof(payload)) {
+		frame_status(cmd, seq, STATUS_BAD_LENGTH);
+		return;
+	}
+	if (job_running() && command_changes_state(cmd)) {
+		frame_status(cmd, seq, STATUS_BUSY);
+		return;
+	}
+
+	const unsigned long started = micros();
+	switch (cmd) {
+		case CMD_STATUS:
+			cmd_status(seq);
+			break;
+
+		case CMD_READ:
+			cmd_read(seq, len);
+			break;
+
+		case CMD_READ_RLE:
+			cmd_read_rle(seq, len);
+			break;
+
+		case CMD_DUMP:
+			cmd_dump(seq, len);
+			break;
+
+		case CMD_PAGE_CRC:
+			cmd_page_crc(seq, len);
+			break;
+
+		case CMD_CRC32:
+			cmd_crc32(seq, len);
+			break;
+
+		case CMD_WRITE:
+		case CMD_VERIFY:
+			cmd_write_verify(cmd, seq, len);
+			break;
+
+		case CMD_WRITE_RLE:
+			cmd_write_rle(seq, len);
+			break;
+
+		case CMD_BAUD:
+			cmd_baud(seq, len);
+			break;
+
+		case CMD_SOCKET:
+			cmd_socket(seq, len);
+			break;
+
+		case CMD_BLANK_CHECK:
+			cmd_blank_check(seq, len);
+			break;
+
+		default:
+			frame_status(cmd, seq, STATUS_UNKNOWN_COMMAND);
+			break;
+	}
+	count_op(command_counter(cmd), micros() - started);
+}
@@ -0,0 +1,137 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Tomas Vecera, tomas@vecera.dev
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef EEPROM_PROTOCOL_H
+#define EEPROM_PROTOCOL_H
+
+/*
+ * Binary command mode for bulk transfers. Every frame, in both directions, is:
+ *
+ *   SOF(0xA5) CMD SEQ LEN_LO LEN_HI PAYLOAD[LEN] CRC_LO CRC_HI
+ *
+ * CRC is CRC-16/CCITT-FALSE over CMD..PAYLOAD. The response echoes CMD and SEQ, the first payload
+ * byte is a status code. All multi-byte values are little endian.
+ */
+#define FRAME_SOF               0xA5
+
+#define CMD_STATUS              0x01   // -> version, EEPROM size (2), page size, max payload, sockets
+#define CMD_READ                0x02   // address (2), length (2) -> data
+#define CMD_WRITE               0x03   // address (2), data -> (changed bytes written, verified)
+#define CMD_VERIFY              0x04   // address (2), data -> mismatch count (2), first mismatch (2)
+#define CMD_PAGE_CRC            0x05   // address (2, page aligned), length (2) -> CRC16 of every page (2 each)
+#define CMD_CRC32               0x06   // address (2), length (2) -> CRC32 of the range (4), same as zlib.crc32
+#define CMD_READ_RLE            0x07   // address (2), length (2) -> bytes covered (2), run-length encoded data
+#define CMD_WRITE_RLE           0x08   // address (2), run-length encoded data -> mismatch count (2), first mismatch (2), decoded length (2)
+#define CMD_BAUD                0x09   // baud rate (4) -> (acknowledged at the old rate, then switched)
+#define CMD_SOCKET              0x0A   // socket -> (selected for READ, READ_RLE, PAGE_CRC and CRC32)
+#define CMD_PROGRESS            0x0B   // <- operation, address (2), done (2), total (2), bytes/s (2), errors (4)
+#define CMD_BLANK_CHECK         0x0C   // address (2), length (2), flags -> dirty blocks (2), first dirty address (2)
+#define CMD_DUMP                0x0D   // address (2), length (2) -> CMD_READ_RLE responses until the range is covered
+
+/*
+ * After CMD_BAUD both sides switch to the new rate and the host sends a test frame, usually CMD_STATUS. Any valid
+ * frame within BAUD_CONFIRM ms confirms the rate, otherwise the programmer falls back to SERIAL_BAUD. Text
+ * commands are ignored until then, so garbled bytes cannot start one.
+ */
+#define BAUD_MIN                9600
+#define BAUD_MAX                2000000
+#define BAUD_CONFIRM            1000
+
+/*
+ * CMD_READ_RLE sends the bytes as they are, except that two equal bytes in a row are followed by a count of
+ * further copies (0-255): AA AA AA AA 12 becomes AA AA 02 12. A response covers as many bytes as fit into
+ * RLE_BUFFER encoded bytes, the host continues with the next request at address + covered. CMD_WRITE_RLE takes
+ * the same encoding, a frame must not end inside a run. A partial page at the end of a frame is written on its own,
+ * so the host should send whole pages: one page always fits, even at 1.5 encoded bytes per byte. The pages of a
+ * frame must be encoded in one pass, pages encoded one by one and joined can merge into a run across the boundary.
+ * The response returns the decoded length for the host to check.
+ *
+ * CMD_DUMP answers with as many CMD_READ_RLE style frames as the range needs, all with the SEQ of the request and
+ * sent back to back, so a whole chip is read without a round trip per RLE_BUFFER. An empty range gets one frame that
+ * covers 0 bytes.
+ */
+#define RLE_BUFFER              128
+
+/*
+ * With several sockets (SOCKET_CE_PINS in main.h) CMD_WRITE and CMD_WRITE_RLE program all of them. CMD_WRITE,
+ * CMD_VERIFY and CMD_WRITE_RLE compare every socket, the mismatch count is the sum and the first mismatch the lowest
+ * address of any socket. The read commands use the socket selected with CMD_SOCKET, socket 0 after reset.
+ */
+
+/*
+ * CMD_PROGRESS is never requested, the programmer sends it with SEQ 0 while a text command job (erase, ROM write,
+ * test) runs, see progress.h. Operation is the letter of the command, address the next one to be processed. Frames
+ * with another CMD or SEQ than the pending request are to be skipped by the host.
+ */
+
+/*
+ * CMD_BLANK_CHECK checks every socket for bytes other than 0xFF, see eeprom_blank_check(). It stops at the first
+ * dirty block unless BLANK_FULL is set in flags. The first dirty address is address + length if the range is blank.
+ */
+#define BLANK_FULL              0x01
+
+/*
+ * While a text command runs a job (E, R or T, see job.h) CMD_WRITE, CMD_WRITE_RLE, CMD_BAUD and CMD_SOCKET are
+ * answered with STATUS_BUSY, they would change the EEPROM, the socket or the serial port under the job. The read
+ * commands keep working.
+ */
+#define STATUS_OK               0x00
+#define STATUS_BAD_CRC          0x01
+#define STATUS_BAD_LENGTH       0x02
+#define STATUS_BAD_ADDRESS      0x03
+#define STATUS_UNKNOWN_COMMAND  0x04
+#define STATUS_VERIFY_FAILED    0x05
+#define STATUS_BAD_VALUE        0x06
+#define STATUS_BUSY             0x07
+
+#define PROTOCOL_VERSION        1
+#define PROTOCOL_MAX_PAYLOAD    (2 + EEPROM_BLOCK_SIZE * 3 / 2)   // Address and a run-length encoded block, worst case
+
+/**
+ * @brief Receive and execute one binary frame. Call it after FRAME_SOF was read from Serial.
+ * Incomplete frames are dropped after a short timeout.
+ */
+void protocol_process_frame();
+
+/**
+ * @brief Fall back to SERIAL_BAUD if a baud rate change was not confirmed in time. Call it from the main loop.
+ * @return True while a baud rate change waits for its confirmation
+ */
+bool protocol_poll();
+
+/**
+ * @brief Check whether a host talks to the programmer, i.e. a valid binary frame has been received since reset.
+ * @return True if a host has sent a valid frame
+ */
+bool protocol_host();
+
+/**
+ * @brief Send an unsolicited frame with SEQ 0 and status STATUS_OK.
+ * @param cmd Command code
+ * @param data Payload after the status byte
+ * @param len Number of bytes
+ */
+void protocol_notify(uint8_t cmd, const uint8_t *data, uint8_t len);
+
+#endif //EEPROM_PROTOCOL_H
@@ -24,56 +24,161 @@
 
 #include "main.h"
 #include "rom.h"
+#include "rom_images.h"
 #include "at28c.h"
+#include "job.h"
 #include "util.h"
 
-/**
-* @brief Writes ROM data to EEPROM with verification
-*
-* Process:
-*  1. Erases target EEPROM section by setting all bytes to 0xFF
-*  2. Writes ROM data from program memory to EEPROM
-*  3. Verifies written data against original ROM
-*
-* @global rom[] - Source ROM data in program memory
-* @uses ROM_SIZE - Size of ROM data to write
-*/
-void eeprom_rom_write() {
-	uint32_t errors = 0;
-	const unsigned long start_time = millis();
+// Decoder of the image being written, the job asks for the pages in order
+static struct {
+	rom_image image;        // Copy of the table entry
+	uint16_t pos;           // Next encoded byte
+	uint16_t run;           // Copies of value left
+	uint8_t value;
+} rom;
 
-	Serial.println();
-	// First, erase the section where ROM will be written
-	Serial.println(F("Step 1: Erasing EEPROM section"));
-	eeprom_erase_section(0, ROM_SIZE, 0xFF);
+/**
+ * @brief Copy a table entry out of program memory.
+ * @param image Image number, must be valid
+ * @param entry Copy of the entry
+ */
+static void rom_entry(const uint8_t image, rom_image *entry) {
+	memcpy_P(entry, &rom_images[image], sizeof(rom_image));
+}
 
-	// Write ROM data
-	Serial.println(F("\nStep 2: Writing ROM data"));
-	for (uint16_t addr = 0; addr < ROM_SIZE; addr++) {
-		uint8_t data = pgm_read_byte(&rom[addr]);
-		eeprom_write_byte(addr, data);
+/**
+ * @brief Get the next decoded byte of the image, two equal bytes are followed by a count of further copies.
+ * @return Data byte
+ */
+static uint8_t rom_next() {
+	if (rom.run == 0) {
+		const uint8_t *data = rom.image.data;
+		rom.value = pgm_read_byte(&data[rom.pos++]);
+		rom.run = 1;
+		if (rom.pos < rom.image.packed && pgm_read_byte(&data[rom.pos]) == rom.value) {
+			rom.run = 2 + pgm_read_byte(&data[rom.pos + 1]);
+			rom.pos += 2;
+		}
+	}
+	rom.run--;
+	return rom.value;
+}
 
-		print_progress(addr);
+/**
+ * @brief Page data of the ROM job, expanded from program memory.
+ */
+static void rom_source(const uint16_t address, uint8_t *buf, const uint8_t len) {
+	for (uint8_t i = 0; i < len; i++) {
+		buf[i] = rom_next();
 	}
-	Serial.println(F("\nWrite complete!"));
+}
 
-	// Verify written data
-	Serial.println(F("\nStep 3: Verifying ROM data"));
-	for (uint16_t addr = 0; addr < ROM_SIZE; addr++) {
-		uint8_t expected = pgm_read_byte(&rom[addr]);
-		if (!eeprom_verify_byte(addr, expected)) errors++;
+/**
+ * @brief Get the number of ROM images in program memory.
+ * @return Number of images
+ */
+uint8_t rom_count() {
+	return ROM_IMAGES;
+}
 
-		print_progress(addr);
+/**
+ * @brief Print the ROM images with their number, name, address range and CRC32.
+ */
+void rom_list() {
+	for (uint8_t i = 0; i < ROM_IMAGES; i++) {
+		rom_image entry;
+		rom_entry(i, &entry);
+		Serial.print(' ');
+		Serial.print(i, HEX);
+		Serial.print(F(" - "));
+		Serial.print(reinterpret_cast<const __FlashStringHelper *>(entry.name));
+		Serial.print(F(" (0x"));
+		Serial.print(entry.start, HEX);
+		Serial.print(F(" - 0x"));
+		Serial.print(entry.start + entry.size - 1, HEX);
+		Serial.print(F(", CRC32 0x"));
+		Serial.print(entry.crc, HEX);
+		Serial.println(F(")"));
 	}
+}
 
-	if (errors == 0) {
-		Serial.println(F("\nVerification successful - ROM written correctly!"));
+/**
+ * @brief End of the ROM job.
+ */
+static void rom_done(const job_result *result) {
+	if (result->aborted) Serial.print(F("\nAborted!"));
+	Serial.print(F("\nWrite complete! Pages written: "));
+	Serial.print(result->written);
+	Serial.print(F(" of "));
+	Serial.println(result->pages);
+
+	if (result->errors == 0) {
+		Serial.println(F("Verification successful - ROM written correctly!"));
 	} else {
-		Serial.print(F("\nVerification failed with "));
-		Serial.print(errors);
+		Serial.print(F("Verification failed with "));
+		Serial.print(result->errors);
 		Serial.println(F(" errors."));
 	}
 
 	Serial.println(F("\nROM Writing Complete!"));
-	print_execution_time(millis() - start_time);
+	print_execution_time(result->ms);
+}
+
+/**
+* @brief Writes a ROM image to EEPROM with verification, as a job run by job_step()
+*
+* Process, page by page:
+*  1. Expands the image from program memory and writes it to EEPROM, pages that already match are skipped
+*  2. Verifies written data against the expanded image
+*
+* @param image Image number, 0 to rom_count() - 1
+* @return False if there is no such image, no job is started then
+*/
+bool eeprom_rom_write(const uint8_t image) {
+	if (image >= ROM_IMAGES) return false;
+	rom_entry(image, &rom.image);
+	rom.pos = 0;
+	rom.run = 0;
+
+	Serial.println();
+	Serial.print(F("Writing and verifying "));
+	Serial.println(reinterpret_cast<const __FlashStringHelper *>(rom.image.name));
+	job_start('R', rom.image.start, rom.image.start + rom.image.size, rom_source, JOB_UPDATE, rom_done);
+	return true;
+}
+
+/**
+ * @brief Compare the CRC32 of the EEPROM range of a ROM image with the CRC32 of the image, in every socket.
+ * @param image Image number, 0 to rom_count() - 1
+ * @return True if every socket holds the image
+ */
+bool eeprom_rom_check(const uint8_t image) {
+	if (image >= ROM_IMAGES) return false;
+	rom_image entry;
+	rom_entry(image, &entry);
+
+	const uint8_t selected = eeprom_selected();
+	bool match = true;
+	for (uint8_t socket = 0; socket < EEPROM_SOCKETS; socket++) {
+		eeprom_select(socket);
+		const uint32_t crc = eeprom_crc32(entry.start, entry.size);
+
+		if (EEPROM_SOCKETS > 1) {
+			Serial.print(F("Socket "));
+			Serial.print(socket);
+			Serial.print(F(": "));
+		}
+		Serial.print(F("CRC32 0x"));
+		Serial.print(crc, HEX);
+		if (crc == entry.crc) {
+			Serial.println(F(" - match"));
+		} else {
+			Serial.print(F(" - expected 0x"));
+			Serial.println(entry.crc, HEX);
+			match = false;
+		}
+	}
+	eeprom_select(selected);
+
+	return match;
 }
@@ -25,113 +25,118 @@
 #ifndef EEPROM_ROM_H
 #define EEPROM_ROM_H
 
+#include "main.h"
+
+/*
+ * ROM images in program memory, packed by cli/pack_roms.py into rom_images.h. The data is run-length encoded like
+ * CMD_WRITE_RLE (see protocol.h) and expanded page by page while it is written. The CRC32 is computed by the pack
+ * script from the decoded image and checked by the compiler, see rom_check(). Checking an EEPROM against it costs
+ * one read of the range and no table.
+ */
+struct rom_image {
+	const char *name;        // Name in program memory
+	const uint8_t *data;     // Encoded data in program memory
+	uint16_t packed;         // Bytes of encoded data
+	uint16_t start;          // EEPROM address of the first byte
+	uint16_t size;           // Bytes after decoding
+	uint32_t crc;            // CRC32 of the decoded bytes, same as zlib.crc32
+};
+
+/*
+ * Compile-time check of rom_images.h: rom_check() decodes an image and compares its size and CRC32 with the table
+ * entry, so a hand-edited or stale header fails the build. C++11 constexpr functions can only recurse, so the data
+ * is walked in blocks of ROM_CHECK_BLOCK tokens and runs are expanded 16 bytes at a time. That keeps the recursion
+ * depth below 200 for a full 64 KB image, the compiler allows 512. Nothing of it ends up in the binary.
+ */
+#define ROM_CHECK_BLOCK  64
+
+// Decoder state of rom_check()
+struct rom_check_state {
+	uint32_t crc;            // CRC32 so far, not inverted yet
+	uint16_t pos;            // Next encoded byte
+	uint32_t size;           // Bytes decoded so far
+	bool valid;              // False if the data ends inside a run
+};
+
+constexpr uint32_t rom_check_bits(const uint32_t crc, const uint8_t bits) {
+	return bits == 0 ? crc : rom_check_bits((crc >> 1) ^ (0xEDB88320UL & (0UL - (crc & 1))), bits - 1);
+}
+
+constexpr uint32_t rom_check_repeat(const uint32_t crc, const uint8_t value, const uint16_t count) {
+	return count == 0 ? crc : rom_check_repeat(rom_check_bits(crc ^ value, 8), value, count - 1);
+}
+
+constexpr uint32_t rom_check_run(const uint32_t crc, const uint8_t value, const uint16_t count) {
+	return count > 16 ? rom_check_run(rom_check_repeat(crc, value, 16), value, count - 16)
+	                  : rom_check_repeat(crc, value, count);
+}
+
+// One token: a data byte, or two equal bytes followed by the count of further copies
+constexpr rom_check_state rom_check_token(const rom_check_state s, const uint8_t *data, const uint16_t len) {
+	return !(s.pos + 1 < len && data[s.pos + 1] == data[s.pos])
+	       ? rom_check_state{rom_check_bits(s.crc ^ data[s.pos], 8), static_cast<uint16_t>(s.pos + 1), s.size + 1, s.valid}
+	       : s.pos + 2 >= len
+	       ? rom_check_state{s.crc, len, s.size, false}
+	       : rom_check_state{rom_check_run(s.crc, data[s.pos], 2 + data[s.pos + 2]), static_cast<uint16_t>(s.pos + 3),
+	                         s.size + 2 + data[s.pos + 2], s.valid};
+}
+
+constexpr rom_check_state rom_check_tokens(const rom_check_state s, const uint8_t *data, const uint16_t len,
+                                           const uint8_t count) {
+	return count == 0 || s.pos >= len ? s : rom_check_tokens(rom_check_token(s, data, len), data, len, count - 1);
+}
+
+constexpr rom_check_state rom_check_blocks(const rom_check_state s, const uint8_t *data, const uint16_t len,
+                                           const uint8_t count) {
+	return count == 0 || s.pos >= len ? s
+	       : rom_check_blocks(rom_check_tokens(s, data, len, ROM_CHECK_BLOCK), data, len, count - 1);
+}
+
+constexpr rom_check_state rom_check_all(const rom_check_state s, const uint8_t *data, const uint16_t len) {
+	return s.pos >= len ? s : rom_check_all(rom_check_blocks(s, data, len, ROM_CHECK_BLOCK), data, len);
+}
+
+constexpr bool rom_check_result(const rom_check_state s, const rom_image image) {
+	return s.valid && s.size == image.size && (s.crc ^ 0xFFFFFFFFUL) == image.crc;
+}
+
+/**
+ * @brief Check at compile time that the data of a table entry decodes to its size and CRC32.
+ * @param image Table entry, constexpr
+ * @return True if the entry matches its data
+ */
+constexpr bool rom_check(const rom_image image) {
+	return rom_check_result(rom_check_all(rom_check_state{0xFFFFFFFFUL, 0, 0, true}, image.data, image.packed), image);
+}
+
 /**
-* @brief Writes ROM data to EEPROM with verification
+ * @brief Get the number of ROM images in program memory.
+ * @return Number of images
+ */
+uint8_t rom_count();
+
+/**
+ * @brief Print the ROM images with their number, name, address range and CRC32.
+ */
+void rom_list();
+
+/**
+* @brief Writes a ROM image to EEPROM with verification, as a job run by job_step()
 *
-* Process:
-*  1. Erases target EEPROM section by setting all bytes to 0xFF
-*  2. Writes ROM data from program memory to EEPROM
-*  3. Verifies written data against original ROM
+* Process, page by page:
+*  1. Expands the image from program memory and writes it to EEPROM, pages that already match are skipped
+*  2. Verifies written data against the expanded image
 *
-* @global rom[] - Source ROM data in program memory
-* @uses ROM_SIZE - Size of ROM data to write
+* @param image Image number, 0 to rom_count() - 1
+* @return False if there is no such image, no job is started then
 */
-void eeprom_rom_write();
-
-// Omen Alpha v3 Monitor ROM - https://github.com/omenmicro/alpha/tree/master/sw/Monitor
-const PROGMEM unsigned char rom[] = {
-  0xf3, 0x31, 0x00, 0xff, 0xc3, 0xaf, 0x00, 0x41, 0xc3, 0x84, 0x00, 0x00,
-  0x00, 0x00, 0x00, 0x00, 0xc3, 0x9e, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
-  0xe3, 0x4e, 0x23, 0xe3, 0xc3, 0x28, 0x00, 0x00, 0xf5, 0x22, 0x01, 0xff,
-  0xe3, 0xc3, 0x45, 0x00, 0xe5, 0xd5, 0x21, 0x36, 0x00, 0x59, 0x16, 0x00,
-  0x19, 0x19, 0x19, 0xd1, 0xe3, 0xc9, 0xc3, 0x00, 0x00, 0xc3, 0xb3, 0x00,
-  0xc3, 0xa7, 0x00, 0xc3, 0x9e, 0x00, 0xc3, 0x84, 0x00, 0x22, 0x07, 0xff,
-  0xf1, 0x21, 0x00, 0x00, 0x39, 0x22, 0x05, 0xff, 0xe1, 0x2b, 0x22, 0x03,
-  0xff, 0x3a, 0x00, 0xff, 0x77, 0xd5, 0xe1, 0x22, 0x0b, 0xff, 0xc5, 0xe1,
-  0x22, 0x09, 0xff, 0x21, 0x78, 0x00, 0xcd, 0x90, 0x00, 0x2a, 0x03, 0xff,
-  0xcd, 0x0d, 0x03, 0x3e, 0x0d, 0xcf, 0x3e, 0x0a, 0xcf, 0xc3, 0xb9, 0x00,
-  0x0d, 0x0a, 0x2a, 0x42, 0x52, 0x45, 0x41, 0x4b, 0x20, 0x61, 0x74, 0xa0,
-  0xf5, 0xdb, 0xde, 0xe6, 0x02, 0xca, 0x85, 0x00, 0xf1, 0xd3, 0xdf, 0xc9,
-  0x7e, 0xe6, 0x7f, 0xcd, 0x84, 0x00, 0x7e, 0xe6, 0x80, 0xc0, 0x23, 0xc3,
-  0x90, 0x00, 0xdb, 0xde, 0xe6, 0x01, 0xc8, 0xdb, 0xdf, 0xb7, 0xc9, 0xdb,
-  0xde, 0xe6, 0x01, 0xc8, 0x3e, 0xff, 0xc9, 0x3e, 0x15, 0xd3, 0xde, 0x21,
-  0x32, 0x03, 0xcd, 0x90, 0x00, 0x3e, 0x3e, 0xcf, 0xcd, 0x9e, 0x00, 0xca,
-  0xbc, 0x00, 0xfe, 0x3a, 0xca, 0x49, 0x02, 0xfe, 0x0d, 0xca, 0xbc, 0x00,
-  0xfe, 0x0a, 0xca, 0xbc, 0x00, 0xfe, 0x61, 0xda, 0xd8, 0x00, 0xde, 0x20,
-  0xfe, 0x4d, 0xca, 0xd1, 0x01, 0xfe, 0x47, 0xca, 0xf6, 0x01, 0xfe, 0x44,
-  0xca, 0xfa, 0x01, 0xfe, 0x42, 0xca, 0x86, 0x02, 0xfe, 0x52, 0xca, 0x11,
-  0x01, 0xfe, 0x58, 0xca, 0x9b, 0x01, 0xfe, 0x43, 0xca, 0xba, 0x01, 0xfe,
-  0x48, 0xca, 0x0b, 0x01, 0xfe, 0x3f, 0xca, 0x0b, 0x01, 0x21, 0x52, 0x03,
-  0xc3, 0xb6, 0x00, 0x21, 0x6b, 0x03, 0xc3, 0xb6, 0x00, 0x21, 0x08, 0xff,
-  0x3e, 0x41, 0xcd, 0x68, 0x01, 0x21, 0x0a, 0xff, 0x3e, 0x42, 0xcd, 0x68,
-  0x01, 0x2b, 0x3e, 0x43, 0xcd, 0x68, 0x01, 0x21, 0x0c, 0xff, 0x3e, 0x44,
-  0xcd, 0x68, 0x01, 0x2b, 0x3e, 0x45, 0xcd, 0x68, 0x01, 0x21, 0x02, 0xff,
-  0x3e, 0x48, 0xcd, 0x68, 0x01, 0x2b, 0x3e, 0x4c, 0xcd, 0x68, 0x01, 0x11,
-  0x64, 0x01, 0x2a, 0x05, 0xff, 0xcd, 0x81, 0x01, 0x22, 0x05, 0xff, 0x11,
-  0x66, 0x01, 0x2a, 0x03, 0xff, 0xcd, 0x81, 0x01, 0x22, 0x03, 0xff, 0x3e,
-  0x0d, 0xcf, 0x3e, 0x0a, 0xcf, 0xc3, 0xb9, 0x00, 0x53, 0xd0, 0x50, 0xc3,
-  0xf5, 0x3e, 0x0d, 0xcf, 0x3e, 0x0a, 0xcf, 0xf1, 0xcf, 0x3e, 0x20, 0xcf,
-  0x7e, 0xcd, 0x12, 0x03, 0x3e, 0x20, 0xcf, 0x4e, 0xcd, 0xdb, 0x02, 0x71,
-  0xc9, 0xe5, 0x3e, 0x0d, 0xcf, 0x3e, 0x0a, 0xcf, 0xd5, 0xe1, 0xcd, 0x90,
-  0x00, 0x3e, 0x20, 0xcf, 0xe1, 0xcd, 0x0d, 0x03, 0x3e, 0x20, 0xcf, 0xcd,
-  0xa2, 0x02, 0xc9, 0xcd, 0x99, 0x02, 0x7e, 0x32, 0x00, 0xff, 0x36, 0xe7,
-  0x21, 0xaa, 0x01, 0xc3, 0xb6, 0x00, 0x42, 0x52, 0x45, 0x41, 0x4b, 0x50,
-  0x4f, 0x49, 0x4e, 0x54, 0x20, 0x53, 0x45, 0x54, 0x0d, 0x8a, 0x2a, 0x03,
-  0xff, 0xe5, 0x2a, 0x07, 0xff, 0xe5, 0x2a, 0x0b, 0xff, 0xe5, 0x2a, 0x09,
-  0xff, 0xe5, 0x2a, 0x01, 0xff, 0xc1, 0xd1, 0xf1, 0xc9, 0xcd, 0x99, 0x02,
-  0x3e, 0x0d, 0xcf, 0x3e, 0x0a, 0xcf, 0xcd, 0x0d, 0x03, 0x3e, 0x20, 0xcf,
-  0x7e, 0xcd, 0x12, 0x03, 0x3e, 0x20, 0xcf, 0x4e, 0xcd, 0xdb, 0x02, 0x71,
-  0x23, 0x78, 0xfe, 0x0d, 0xca, 0xd4, 0x01, 0xc3, 0xb9, 0x00, 0xcd, 0x99,
-  0x02, 0xe9, 0xcd, 0x99, 0x02, 0x3e, 0x0d, 0xcf, 0x3e, 0x0a, 0xcf, 0xcd,
-  0x0d, 0x03, 0x0e, 0x10, 0x3e, 0x20, 0xcf, 0xe5, 0x7e, 0xcd, 0x12, 0x03,
-  0x23, 0x0d, 0xc2, 0x0c, 0x02, 0xe1, 0x3e, 0x20, 0xcf, 0x0e, 0x10, 0x7e,
-  0xfe, 0x20, 0xda, 0x26, 0x02, 0xfe, 0x80, 0xda, 0x28, 0x02, 0x3e, 0x2e,
-  0xcd, 0x84, 0x00, 0x23, 0x0d, 0xc2, 0x1b, 0x02, 0x3e, 0x0d, 0xcf, 0x3e,
-  0x0a, 0xcf, 0xcd, 0x9e, 0x00, 0xca, 0x36, 0x02, 0xfe, 0x20, 0xca, 0xb9,
-  0x00, 0xfe, 0x0d, 0xca, 0x03, 0x02, 0xc3, 0x36, 0x02, 0xcd, 0xb9, 0x02,
-  0x4f, 0x5f, 0xcd, 0xd2, 0x02, 0x7b, 0x84, 0x85, 0x5f, 0xcd, 0xb9, 0x02,
-  0xb7, 0xc2, 0x81, 0x02, 0x83, 0x5f, 0xcd, 0xb9, 0x02, 0x77, 0x83, 0x5f,
-  0x23, 0x0d, 0xc2, 0x5e, 0x02, 0x7c, 0xcd, 0x12, 0x03, 0x7d, 0xcd, 0x12,
-  0x03, 0xcd, 0xb9, 0x02, 0x83, 0xca, 0xb9, 0x00, 0x21, 0x5e, 0x03, 0xcd,
-  0x90, 0x00, 0xc3, 0xb9, 0x00, 0x83, 0x5f, 0xc3, 0x69, 0x02, 0x3a, 0x00,
-  0x10, 0xfe, 0x31, 0xc2, 0x05, 0x01, 0x3a, 0x03, 0x10, 0xfe, 0x3e, 0xc2,
-  0x05, 0x01, 0xc3, 0x00, 0x10, 0x21, 0x59, 0x03, 0xcd, 0x90, 0x00, 0x21,
-  0x00, 0x00, 0xcd, 0x9e, 0x00, 0xca, 0xa2, 0x02, 0xcf, 0xcd, 0xf7, 0x02,
-  0xd8, 0xcd, 0x05, 0x03, 0x29, 0x29, 0x29, 0x29, 0x85, 0x6f, 0xc3, 0xa2,
-  0x02, 0xcd, 0x9e, 0x00, 0xca, 0xb9, 0x02, 0xcd, 0x05, 0x03, 0x87, 0x87,
-  0x87, 0x87, 0x47, 0xcd, 0x9e, 0x00, 0xca, 0xc7, 0x02, 0xcd, 0x05, 0x03,
-  0x80, 0xc9, 0xcd, 0xb9, 0x02, 0x67, 0xcd, 0xb9, 0x02, 0x6f, 0xc9, 0x06,
-  0x00, 0xcd, 0x9e, 0x00, 0xca, 0xdd, 0x02, 0xcf, 0xcd, 0xf7, 0x02, 0x47,
-  0xd8, 0xcd, 0x05, 0x03, 0x57, 0x79, 0x87, 0x87, 0x87, 0x87, 0x82, 0x4f,
-  0xc3, 0xdd, 0x02, 0xfe, 0x47, 0x3f, 0xd8, 0xfe, 0x30, 0xd8, 0xfe, 0x3a,
-  0x3f, 0xd0, 0xfe, 0x41, 0xc9, 0xde, 0x30, 0xfe, 0x0a, 0xd8, 0xde, 0x07,
-  0xc9, 0x7c, 0xcd, 0x12, 0x03, 0x7d, 0xf5, 0x1f, 0x1f, 0x1f, 0x1f, 0xe6,
-  0x0f, 0xc6, 0x30, 0xfe, 0x3a, 0xda, 0x22, 0x03, 0xc6, 0x07, 0xcf, 0xf1,
-  0xe6, 0x0f, 0xc6, 0x30, 0xfe, 0x3a, 0xda, 0x84, 0x00, 0xc6, 0x07, 0xc3,
-  0x84, 0x00, 0x4f, 0x4d, 0x45, 0x4e, 0x20, 0x41, 0x4c, 0x50, 0x48, 0x41,
-  0x0d, 0x0a, 0x4d, 0x4f, 0x4e, 0x49, 0x54, 0x4f, 0x52, 0x20, 0x56, 0x33,
-  0x0d, 0x0a, 0x52, 0x45, 0x41, 0x44, 0x59, 0x0d, 0x0a, 0x8a, 0x57, 0x48,
-  0x41, 0x54, 0x3f, 0x0d, 0x8a, 0x41, 0x64, 0x64, 0x72, 0xba, 0x43, 0x68,
-  0x6b, 0x20, 0x65, 0x72, 0xf2, 0x44, 0x4f, 0x4e, 0x45, 0x0d, 0x8a, 0x0d,
-  0x0a, 0x43, 0x4f, 0x4d, 0x4d, 0x41, 0x4e, 0x44, 0x53, 0x3a, 0x0d, 0x0a,
-  0x4d, 0x3a, 0x20, 0x53, 0x68, 0x6f, 0x77, 0x20, 0x2f, 0x20, 0x61, 0x6c,
-  0x74, 0x65, 0x72, 0x20, 0x6d, 0x65, 0x6d, 0x6f, 0x72, 0x79, 0x0d, 0x0a,
-  0x44, 0x3a, 0x20, 0x44, 0x75, 0x6d, 0x70, 0x20, 0x6d, 0x65, 0x6d, 0x6f,
-  0x72, 0x79, 0x0d, 0x0a, 0x47, 0x3a, 0x20, 0x47, 0x6f, 0x20, 0x74, 0x6f,
-  0x20, 0x61, 0x64, 0x64, 0x72, 0x65, 0x73, 0x73, 0x20, 0x28, 0x52, 0x75,
-  0x6e, 0x29, 0x0d, 0x0a, 0x42, 0x3a, 0x20, 0x53, 0x74, 0x61, 0x72, 0x74,
-  0x20, 0x42, 0x41, 0x53, 0x49, 0x43, 0x20, 0x28, 0x69, 0x66, 0x20, 0x73,
-  0x74, 0x6f, 0x72, 0x65, 0x64, 0x20, 0x61, 0x74, 0x20, 0x31, 0x30, 0x30,
-  0x30, 0x68, 0x29, 0x0d, 0x0a, 0x58, 0x3a, 0x20, 0x53, 0x65, 0x74, 0x20,
-  0x62, 0x72, 0x65, 0x61, 0x6b, 0x70, 0x6f, 0x69, 0x6e, 0x74, 0x0d, 0x0a,
-  0x43, 0x3a, 0x20, 0x43, 0x6f, 0x6e, 0x74, 0x69, 0x6e, 0x75, 0x65, 0x20,
-  0x61, 0x66, 0x74, 0x65, 0x72, 0x20, 0x62, 0x72, 0x65, 0x61, 0x6b, 0x0d,
-  0x0a, 0x52, 0x3a, 0x20, 0x53, 0x68, 0x6f, 0x77, 0x20, 0x2f, 0x20, 0x61,
-  0x6c, 0x74, 0x65, 0x72, 0x20, 0x72, 0x65, 0x67, 0x69, 0x73, 0x74, 0x65,
-  0x72, 0x73, 0x20, 0x28, 0x75, 0x73, 0x65, 0x20, 0x69, 0x6e, 0x20, 0x62,
-  0x72, 0x65, 0x61, 0x6b, 0x29, 0x0d, 0x8a
-};
+bool eeprom_rom_write(uint8_t image);
 
-const uint16_t ROM_SIZE = sizeof(rom);
+/**
+ * @brief Compare the CRC32 of the EEPROM range of a ROM image with the CRC32 of the image, in every socket.
+ * @param image Image number, 0 to rom_count() - 1
+ * @return True if every socket holds the image
+ */
+bool eeprom_rom_check(uint8_t image);
 
 #endif //EEPROM_ROM_H
@@ -0,0 +1,113 @@
+// Generated by cli/pack_roms.py, do not edit. Included by rom.cpp only.
+
+#ifndef EEPROM_ROM_IMAGES_H
+#define EEPROM_ROM_IMAGES_H
+
+#include "chip.h"
+#include "rom.h"
+
+// Omen Alpha v3 Monitor: 1075 bytes at 0x0000, 1074 bytes encoded
+static constexpr char rom_name_0[] PROGMEM = "Omen Alpha v3 Monitor";
+static constexpr uint8_t rom_data_0[] PROGMEM = {
+	0xf3, 0x31, 0x00, 0xff, 0xc3, 0xaf, 0x00, 0x41, 0xc3, 0x84, 0x00, 0x00,
+	0x04, 0xc3, 0x9e, 0x00, 0x00, 0x04, 0xe3, 0x4e, 0x23, 0xe3, 0xc3, 0x28,
+	0x00, 0x00, 0x00, 0xf5, 0x22, 0x01, 0xff, 0xe3, 0xc3, 0x45, 0x00, 0xe5,
+	0xd5, 0x21, 0x36, 0x00, 0x59, 0x16, 0x00, 0x19, 0x19, 0x01, 0xd1, 0xe3,
+	0xc9, 0xc3, 0x00, 0x00, 0x00, 0xc3, 0xb3, 0x00, 0xc3, 0xa7, 0x00, 0xc3,
+	0x9e, 0x00, 0xc3, 0x84, 0x00, 0x22, 0x07, 0xff, 0xf1, 0x21, 0x00, 0x00,
+	0x00, 0x39, 0x22, 0x05, 0xff, 0xe1, 0x2b, 0x22, 0x03, 0xff, 0x3a, 0x00,
+	0xff, 0x77, 0xd5, 0xe1, 0x22, 0x0b, 0xff, 0xc5, 0xe1, 0x22, 0x09, 0xff,
+	0x21, 0x78, 0x00, 0xcd, 0x90, 0x00, 0x2a, 0x03, 0xff, 0xcd, 0x0d, 0x03,
+	0x3e, 0x0d, 0xcf, 0x3e, 0x0a, 0xcf, 0xc3, 0xb9, 0x00, 0x0d, 0x0a, 0x2a,
+	0x42, 0x52, 0x45, 0x41, 0x4b, 0x20, 0x61, 0x74, 0xa0, 0xf5, 0xdb, 0xde,
+	0xe6, 0x02, 0xca, 0x85, 0x00, 0xf1, 0xd3, 0xdf, 0xc9, 0x7e, 0xe6, 0x7f,
+	0xcd, 0x84, 0x00, 0x7e, 0xe6, 0x80, 0xc0, 0x23, 0xc3, 0x90, 0x00, 0xdb,
+	0xde, 0xe6, 0x01, 0xc8, 0xdb, 0xdf, 0xb7, 0xc9, 0xdb, 0xde, 0xe6, 0x01,
+	0xc8, 0x3e, 0xff, 0xc9, 0x3e, 0x15, 0xd3, 0xde, 0x21, 0x32, 0x03, 0xcd,
+	0x90, 0x00, 0x3e, 0x3e, 0x00, 0xcf, 0xcd, 0x9e, 0x00, 0xca, 0xbc, 0x00,
+	0xfe, 0x3a, 0xca, 0x49, 0x02, 0xfe, 0x0d, 0xca, 0xbc, 0x00, 0xfe, 0x0a,
+	0xca, 0xbc, 0x00, 0xfe, 0x61, 0xda, 0xd8, 0x00, 0xde, 0x20, 0xfe, 0x4d,
+	0xca, 0xd1, 0x01, 0xfe, 0x47, 0xca, 0xf6, 0x01, 0xfe, 0x44, 0xca, 0xfa,
+	0x01, 0xfe, 0x42, 0xca, 0x86, 0x02, 0xfe, 0x52, 0xca, 0x11, 0x01, 0xfe,
+	0x58, 0xca, 0x9b, 0x01, 0xfe, 0x43, 0xca, 0xba, 0x01, 0xfe, 0x48, 0xca,
+	0x0b, 0x01, 0xfe, 0x3f, 0xca, 0x0b, 0x01, 0x21, 0x52, 0x03, 0xc3, 0xb6,
+	0x00, 0x21, 0x6b, 0x03, 0xc3, 0xb6, 0x00, 0x21, 0x08, 0xff, 0x3e, 0x41,
+	0xcd, 0x68, 0x01, 0x21, 0x0a, 0xff, 0x3e, 0x42, 0xcd, 0x68, 0x01, 0x2b,
+	0x3e, 0x43, 0xcd, 0x68, 0x01, 0x21, 0x0c, 0xff, 0x3e, 0x44, 0xcd, 0x68,
+	0x01, 0x2b, 0x3e, 0x45, 0xcd, 0x68, 0x01, 0x21, 0x02, 0xff, 0x3e, 0x48,
+	0xcd, 0x68, 0x01, 0x2b, 0x3e, 0x4c, 0xcd, 0x68, 0x01, 0x11, 0x64, 0x01,
+	0x2a, 0x05, 0xff, 0xcd, 0x81, 0x01, 0x22, 0x05, 0xff, 0x11, 0x66, 0x01,
+	0x2a, 0x03, 0xff, 0xcd, 0x81, 0x01, 0x22, 0x03, 0xff, 0x3e, 0x0d, 0xcf,
+	0x3e, 0x0a, 0xcf, 0xc3, 0xb9, 0x00, 0x53, 0xd0, 0x50, 0xc3, 0xf5, 0x3e,
+	0x0d, 0xcf, 0x3e, 0x0a, 0xcf, 0xf1, 0xcf, 0x3e, 0x20, 0xcf, 0x7e, 0xcd,
+	0x12, 0x03, 0x3e, 0x20, 0xcf, 0x4e, 0xcd, 0xdb, 0x02, 0x71, 0xc9, 0xe5,
+	0x3e, 0x0d, 0xcf, 0x3e, 0x0a, 0xcf, 0xd5, 0xe1, 0xcd, 0x90, 0x00, 0x3e,
+	0x20, 0xcf, 0xe1, 0xcd, 0x0d, 0x03, 0x3e, 0x20, 0xcf, 0xcd, 0xa2, 0x02,
+	0xc9, 0xcd, 0x99, 0x02, 0x7e, 0x32, 0x00, 0xff, 0x36, 0xe7, 0x21, 0xaa,
+	0x01, 0xc3, 0xb6, 0x00, 0x42, 0x52, 0x45, 0x41, 0x4b, 0x50, 0x4f, 0x49,
+	0x4e, 0x54, 0x20, 0x53, 0x45, 0x54, 0x0d, 0x8a, 0x2a, 0x03, 0xff, 0xe5,
+	0x2a, 0x07, 0xff, 0xe5, 0x2a, 0x0b, 0xff, 0xe5, 0x2a, 0x09, 0xff, 0xe5,
+	0x2a, 0x01, 0xff, 0xc1, 0xd1, 0xf1, 0xc9, 0xcd, 0x99, 0x02, 0x3e, 0x0d,
+	0xcf, 0x3e, 0x0a, 0xcf, 0xcd, 0x0d, 0x03, 0x3e, 0x20, 0xcf, 0x7e, 0xcd,
+	0x12, 0x03, 0x3e, 0x20, 0xcf, 0x4e, 0xcd, 0xdb, 0x02, 0x71, 0x23, 0x78,
+	0xfe, 0x0d, 0xca, 0xd4, 0x01, 0xc3, 0xb9, 0x00, 0xcd, 0x99, 0x02, 0xe9,
+	0xcd, 0x99, 0x02, 0x3e, 0x0d, 0xcf, 0x3e, 0x0a, 0xcf, 0xcd, 0x0d, 0x03,
+	0x0e, 0x10, 0x3e, 0x20, 0xcf, 0xe5, 0x7e, 0xcd, 0x12, 0x03, 0x23, 0x0d,
+	0xc2, 0x0c, 0x02, 0xe1, 0x3e, 0x20, 0xcf, 0x0e, 0x10, 0x7e, 0xfe, 0x20,
+	0xda, 0x26, 0x02, 0xfe, 0x80, 0xda, 0x28, 0x02, 0x3e, 0x2e, 0xcd, 0x84,
+	0x00, 0x23, 0x0d, 0xc2, 0x1b, 0x02, 0x3e, 0x0d, 0xcf, 0x3e, 0x0a, 0xcf,
+	0xcd, 0x9e, 0x00, 0xca, 0x36, 0x02, 0xfe, 0x20, 0xca, 0xb9, 0x00, 0xfe,
+	0x0d, 0xca, 0x03, 0x02, 0xc3, 0x36, 0x02, 0xcd, 0xb9, 0x02, 0x4f, 0x5f,
+	0xcd, 0xd2, 0x02, 0x7b, 0x84, 0x85, 0x5f, 0xcd, 0xb9, 0x02, 0xb7, 0xc2,
+	0x81, 0x02, 0x83, 0x5f, 0xcd, 0xb9, 0x02, 0x77, 0x83, 0x5f, 0x23, 0x0d,
+	0xc2, 0x5e, 0x02, 0x7c, 0xcd, 0x12, 0x03, 0x7d, 0xcd, 0x12, 0x03, 0xcd,
+	0xb9, 0x02, 0x83, 0xca, 0xb9, 0x00, 0x21, 0x5e, 0x03, 0xcd, 0x90, 0x00,
+	0xc3, 0xb9, 0x00, 0x83, 0x5f, 0xc3, 0x69, 0x02, 0x3a, 0x00, 0x10, 0xfe,
+	0x31, 0xc2, 0x05, 0x01, 0x3a, 0x03, 0x10, 0xfe, 0x3e, 0xc2, 0x05, 0x01,
+	0xc3, 0x00, 0x10, 0x21, 0x59, 0x03, 0xcd, 0x90, 0x00, 0x21, 0x00, 0x00,
+	0x00, 0xcd, 0x9e, 0x00, 0xca, 0xa2, 0x02, 0xcf, 0xcd, 0xf7, 0x02, 0xd8,
+	0xcd, 0x05, 0x03, 0x29, 0x29, 0x02, 0x85, 0x6f, 0xc3, 0xa2, 0x02, 0xcd,
+	0x9e, 0x00, 0xca, 0xb9, 0x02, 0xcd, 0x05, 0x03, 0x87, 0x87, 0x02, 0x47,
+	0xcd, 0x9e, 0x00, 0xca, 0xc7, 0x02, 0xcd, 0x05, 0x03, 0x80, 0xc9, 0xcd,
+	0xb9, 0x02, 0x67, 0xcd, 0xb9, 0x02, 0x6f, 0xc9, 0x06, 0x00, 0xcd, 0x9e,
+	0x00, 0xca, 0xdd, 0x02, 0xcf, 0xcd, 0xf7, 0x02, 0x47, 0xd8, 0xcd, 0x05,
+	0x03, 0x57, 0x79, 0x87, 0x87, 0x02, 0x82, 0x4f, 0xc3, 0xdd, 0x02, 0xfe,
+	0x47, 0x3f, 0xd8, 0xfe, 0x30, 0xd8, 0xfe, 0x3a, 0x3f, 0xd0, 0xfe, 0x41,
+	0xc9, 0xde, 0x30, 0xfe, 0x0a, 0xd8, 0xde, 0x07, 0xc9, 0x7c, 0xcd, 0x12,
+	0x03, 0x7d, 0xf5, 0x1f, 0x1f, 0x02, 0xe6, 0x0f, 0xc6, 0x30, 0xfe, 0x3a,
+	0xda, 0x22, 0x03, 0xc6, 0x07, 0xcf, 0xf1, 0xe6, 0x0f, 0xc6, 0x30, 0xfe,
+	0x3a, 0xda, 0x84, 0x00, 0xc6, 0x07, 0xc3, 0x84, 0x00, 0x4f, 0x4d, 0x45,
+	0x4e, 0x20, 0x41, 0x4c, 0x50, 0x48, 0x41, 0x0d, 0x0a, 0x4d, 0x4f, 0x4e,
+	0x49, 0x54, 0x4f, 0x52, 0x20, 0x56, 0x33, 0x0d, 0x0a, 0x52, 0x45, 0x41,
+	0x44, 0x59, 0x0d, 0x0a, 0x8a, 0x57, 0x48, 0x41, 0x54, 0x3f, 0x0d, 0x8a,
+	0x41, 0x64, 0x64, 0x00, 0x72, 0xba, 0x43, 0x68, 0x6b, 0x20, 0x65, 0x72,
+	0xf2, 0x44, 0x4f, 0x4e, 0x45, 0x0d, 0x8a, 0x0d, 0x0a, 0x43, 0x4f, 0x4d,
+	0x4d, 0x00, 0x41, 0x4e, 0x44, 0x53, 0x3a, 0x0d, 0x0a, 0x4d, 0x3a, 0x20,
+	0x53, 0x68, 0x6f, 0x77, 0x20, 0x2f, 0x20, 0x61, 0x6c, 0x74, 0x65, 0x72,
+	0x20, 0x6d, 0x65, 0x6d, 0x6f, 0x72, 0x79, 0x0d, 0x0a, 0x44, 0x3a, 0x20,
+	0x44, 0x75, 0x6d, 0x70, 0x20, 0x6d, 0x65, 0x6d, 0x6f, 0x72, 0x79, 0x0d,
+	0x0a, 0x47, 0x3a, 0x20, 0x47, 0x6f, 0x20, 0x74, 0x6f, 0x20, 0x61, 0x64,
+	0x64, 0x00, 0x72, 0x65, 0x73, 0x73, 0x00, 0x20, 0x28, 0x52, 0x75, 0x6e,
+	0x29, 0x0d, 0x0a, 0x42, 0x3a, 0x20, 0x53, 0x74, 0x61, 0x72, 0x74, 0x20,
+	0x42, 0x41, 0x53, 0x49, 0x43, 0x20, 0x28, 0x69, 0x66, 0x20, 0x73, 0x74,
+	0x6f, 0x72, 0x65, 0x64, 0x20, 0x61, 0x74, 0x20, 0x31, 0x30, 0x30, 0x01,
+	0x68, 0x29, 0x0d, 0x0a, 0x58, 0x3a, 0x20, 0x53, 0x65, 0x74, 0x20, 0x62,
+	0x72, 0x65, 0x61, 0x6b, 0x70, 0x6f, 0x69, 0x6e, 0x74, 0x0d, 0x0a, 0x43,
+	0x3a, 0x20, 0x43, 0x6f, 0x6e, 0x74, 0x69, 0x6e, 0x75, 0x65, 0x20, 0x61,
+	0x66, 0x74, 0x65, 0x72, 0x20, 0x62, 0x72, 0x65, 0x61, 0x6b, 0x0d, 0x0a,
+	0x52, 0x3a, 0x20, 0x53, 0x68, 0x6f, 0x77, 0x20, 0x2f, 0x20, 0x61, 0x6c,
+	0x74, 0x65, 0x72, 0x20, 0x72, 0x65, 0x67, 0x69, 0x73, 0x74, 0x65, 0x72,
+	0x73, 0x20, 0x28, 0x75, 0x73, 0x65, 0x20, 0x69, 0x6e, 0x20, 0x62, 0x72,
+	0x65, 0x61, 0x6b, 0x29, 0x0d, 0x8a,
+};
+static_assert(0x0000 + 1075 <= EEPROM_SIZE, "Omen Alpha v3 Monitor does not fit the EEPROM");
+
+static constexpr rom_image rom_images[] PROGMEM = {
+	{rom_name_0, rom_data_0, sizeof(rom_data_0), 0x0000, 1075, 0x39CE139BUL},
+};
+
+static_assert(rom_check(rom_images[0]), "Omen Alpha v3 Monitor: size or CRC32 does not match the data, run cli/pack_roms.py");
+
+#define ROM_IMAGES  (sizeof(rom_images) / sizeof(rom_images[0]))
+
+#endif //EEPROM_ROM_IMAGES_H
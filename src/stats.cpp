@@ -0,0 +1,127 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Tomas Vecera, tomas@vecera.dev
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "main.h"
+#include "stats.h"
+
+#define STATS_BAR_WIDTH    40   // Characters of the longest histogram bar
+
+// Write cycle statistics since power on or the last reset
+static struct {
+	uint16_t cycles;                    // Cycles with a measured time
+	uint16_t untimed;                   // Cycles that completed before the wait started
+	uint16_t timeouts;                  // Cycles that did not complete in time
+	uint32_t total_us;                  // Sum of measured cycle times
+	uint16_t min_us;
+	uint16_t max_us;
+	uint32_t total_polls;
+	uint16_t max_polls;
+	uint16_t histogram[STATS_BUCKETS];  // Measured cycles per 1 ms of cycle time
+} stats;
+
+/**
+ * @brief Record a write cycle whose end was observed, the time is measured from the last loaded byte.
+ * @param us Cycle time in microseconds
+ * @param polls Number of status reads over I2C, 0 if RDY/BUSY signalled the end
+ */
+void stats_write_cycle(unsigned long us, const uint16_t polls) {
+	if (stats.cycles == UINT16_MAX) return;
+	if (us > UINT16_MAX) us = UINT16_MAX;
+
+	if (stats.cycles == 0 || us < stats.min_us) stats.min_us = us;
+	if (us > stats.max_us) stats.max_us = us;
+	if (polls > stats.max_polls) stats.max_polls = polls;
+	stats.total_us += us;
+	stats.total_polls += polls;
+	stats.cycles++;
+
+	const uint8_t bucket = us / 1000;
+	stats.histogram[bucket < STATS_BUCKETS ? bucket : STATS_BUCKETS - 1]++;
+}
+
+/**
+ * @brief Record a write cycle that completed before anybody waited for it, its time is unknown.
+ */
+void stats_write_untimed() {
+	if (stats.untimed < UINT16_MAX) stats.untimed++;
+}
+
+/**
+ * @brief Record a write cycle that did not complete within the timeout.
+ */
+void stats_write_timeout() {
+	if (stats.timeouts < UINT16_MAX) stats.timeouts++;
+}
+
+/**
+ * @brief Clear all write cycle statistics.
+ */
+void stats_reset() {
+	memset(&stats, 0, sizeof(stats));
+}
+
+/**
+ * @brief Print the write cycle statistics: counts, min/mean/max cycle time, polls and the cycle time histogram.
+ */
+void stats_print() {
+	Serial.print(F("Write cycles: "));
+	Serial.print(stats.cycles);
+	Serial.print(F(" timed, "));
+	Serial.print(stats.untimed);
+	Serial.print(F(" untimed, "));
+	Serial.print(stats.timeouts);
+	Serial.println(F(" timeouts"));
+	if (stats.cycles == 0) return;
+
+	Serial.print(F("Cycle time: min "));
+	Serial.print(stats.min_us);
+	Serial.print(F(" us, mean "));
+	Serial.print(stats.total_us / stats.cycles);
+	Serial.print(F(" us, max "));
+	Serial.print(stats.max_us);
+	Serial.println(F(" us"));
+
+	Serial.print(F("Polls: mean "));
+	Serial.print(stats.total_polls / stats.cycles);
+	Serial.print(F(", max "));
+	Serial.println(stats.max_polls);
+
+	uint16_t peak = 1;
+	for (uint8_t i = 0; i < STATS_BUCKETS; i++) {
+		if (stats.histogram[i] > peak) peak = stats.histogram[i];
+	}
+
+	// One line per bucket, starting at its cycle time in ms
+	Serial.println(F("Histogram:"));
+	for (uint8_t i = 0; i < STATS_BUCKETS; i++) {
+		if (i < 10) Serial.print(' ');
+		Serial.print(i);
+		Serial.print(i < STATS_BUCKETS - 1 ? F("  ms: ") : F("+ ms: "));
+		Serial.print(stats.histogram[i]);
+		Serial.print(' ');
+		const uint8_t bar = static_cast<uint32_t>(stats.histogram[i]) * STATS_BAR_WIDTH / peak;
+		for (uint8_t j = 0; j < bar; j++) Serial.print('#');
+		Serial.println();
+	}
+}
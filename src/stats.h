@@ -0,0 +1,57 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2024 Tomas Vecera, tomas@vecera.dev
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef EEPROM_STATS_H
+#define EEPROM_STATS_H
+
+#define STATS_BUCKETS      12   // Histogram buckets of 1 ms, the last one collects everything longer
+
+/**
+ * @brief Record a write cycle whose end was observed, the time is measured from the last loaded byte.
+ * @param us Cycle time in microseconds
+ * @param polls Number of status reads over I2C, 0 if RDY/BUSY signalled the end
+ */
+void stats_write_cycle(unsigned long us, uint16_t polls);
+
+/**
+ * @brief Record a write cycle that completed before anybody waited for it, its time is unknown.
+ */
+void stats_write_untimed();
+
+/**
+ * @brief Record a write cycle that did not complete within the timeout.
+ */
+void stats_write_timeout();
+
+/**
+ * @brief Clear all write cycle statistics.
+ */
+void stats_reset();
+
+/**
+ * @brief Print the write cycle statistics: counts, min/mean/max cycle time, polls and the cycle time histogram.
+ */
+void stats_print();
+
+#endif //EEPROM_STATS_H
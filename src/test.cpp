@@ -25,140 +25,230 @@
 #include "main.h"
 #include "test.h"
 #include "at28c.h"
+#include "job.h"
 #include "util.h"
 
-// Walking 1's
-#define PATTERN_1 (1 << (addr & 7))
-// Address as data
-#define PATTERN_2 (addr & 0xFF)
-// Alternating 0x55 and 0xAA
-#define PATTERN_3 ((addr & 1) ? 0xAA : 0x55)
-// All zeros
-#define PATTERN_4 0x00
-// All ones
-#define PATTERN_5 0xFF
-// Inverted address
-#define PATTERN_6 (~addr & 0xFF)
+// Data patterns, the value of each byte depends on its address
+#define PATTERN_WALKING    1   // Walking 1's
+#define PATTERN_ADDRESS    2   // Address as data
+#define PATTERN_ALTERNATE  3   // Alternating 0x55 and 0xAA
+#define PATTERN_INVERTED   4   // Inverted address
+#define PATTERN_ZEROS      5   // All zeros, March background
+#define PATTERN_ONES       6   // All ones, inverted March background
+#define PATTERN_NONE       0
+
+// One pass over the tested blocks: check the pattern written before (optional), then write the next one
+struct test_step {
+	uint8_t before;    // Pattern expected before the write, PATTERN_NONE to skip the check
+	uint8_t write;     // Pattern written and verified, with JOB_READ only compared
+	uint8_t flags;     // JOB_DOWN, JOB_READ
+};
+
+/*
+ * The data patterns cover the data lines and neighbouring bits across the whole array. The March X sequence
+ * that follows finds address faults: a write that also lands in another block shows up in the check before that
+ * block is written. The order of the blocks is the point, a page is the unit of every element:
+ *   M0 (w0), M1 up (r0, w1), M2 down (r1, w0), M3 (r0)
+ */
+static const test_step test_steps[] = {
+	{PATTERN_NONE,  PATTERN_WALKING,   0},
+	{PATTERN_NONE,  PATTERN_ADDRESS,   0},
+	{PATTERN_NONE,  PATTERN_ALTERNATE, 0},
+	{PATTERN_NONE,  PATTERN_INVERTED,  0},
+	{PATTERN_NONE,  PATTERN_ZEROS,     0},
+	{PATTERN_ZEROS, PATTERN_ONES,      0},
+	{PATTERN_ONES,  PATTERN_ZEROS,     JOB_DOWN},
+	{PATTERN_NONE,  PATTERN_ZEROS,     JOB_READ},
+};
+
+#define TEST_STEPS  (sizeof(test_steps) / sizeof(test_steps[0]))
 
 /**
- * @brief Tests EEPROM memory region by writing and verifying test patterns.
- *
- * This function writes a specified test pattern to each byte in the given EEPROM
- * address range and verifies the written values. It prints progress indicators
- * during testing and reports completion status.
- *
- * @param start   Starting address of EEPROM region to test (inclusive)
- * @param stop    Ending address of EEPROM region to test (exclusive)
- * @param type    Test pattern type (1-6) to write
- * @param name    Name of the test/region being tested (for progress output)
- * @param errors  Pointer to error counter that will be incremented for each
- *                verification failure
+ * @brief Number of address bits above the block offset, constexpr for the sample count.
  */
-static void eeprom_test_pattern(const uint16_t start, const uint16_t stop, const uint8_t type,
-                                const __FlashStringHelper *name, uint32_t *errors) {
-	Serial.print(F("Testing "));
-	Serial.print(name);
-	Serial.print(F(" (0x"));
-	Serial.print(start, HEX);
-	Serial.print(F(" - 0x"));
-	Serial.print(stop, HEX);
-	Serial.println(F(")"));
-
-	for (uint16_t addr = start; addr < stop; addr++) {
-		uint8_t pattern;
+static constexpr uint8_t block_address_bits(const uint32_t blocks) {
+	return blocks <= 1 ? 0 : 1 + block_address_bits(blocks / 2);
+}
+
+// Quick test: the first block, one block per address line above the block offset, and the last block
+static constexpr uint8_t sample_blocks = block_address_bits(EEPROM_SIZE / EEPROM_BLOCK_SIZE) + 2;
+
+// State of the running test
+static struct {
+	uint8_t step;           // Index into test_steps
+	uint8_t sample;         // Block of the quick test within the step
+	bool quick;
+	uint32_t errors;
+	unsigned long start_time;
+} test;
+
+/**
+ * @brief Get the name of a test step.
+ * @param step Index into test_steps
+ * @return Name of the step
+ */
+static const __FlashStringHelper *test_name(const uint8_t step) {
+	switch (step) {
+		case 0: return F("Pattern 1: Walking 1's");
+		case 1: return F("Pattern 2: Address as data");
+		case 2: return F("Pattern 3: Alternating 0x55/0xAA");
+		case 3: return F("Pattern 4: Inverted address");
+		case 4: return F("March M0: Write 0x00");
+		case 5: return F("March M1: Up, check 0x00, write 0xFF");
+		case 6: return F("March M2: Down, check 0xFF, write 0x00");
+		default: return F("March M3: Check 0x00");
+	}
+}
+
+/**
+ * @brief Fill a buffer with a test pattern.
+ * @param type Pattern type (PATTERN_*)
+ * @param address EEPROM address of the first byte
+ * @param buf Buffer for the data
+ * @param len Number of bytes
+ */
+static void test_pattern(const uint8_t type, const uint16_t address, uint8_t *buf, const uint8_t len) {
+	for (uint8_t i = 0; i < len; i++) {
+		const uint16_t addr = address + i;
 		switch (type) {
-			case 1: pattern = PATTERN_1;
+			case PATTERN_WALKING: buf[i] = 1 << (addr & 7);
 				break;
-			case 2: pattern = PATTERN_2;
+			case PATTERN_ADDRESS: buf[i] = addr & 0xFF;
 				break;
-			case 3: pattern = PATTERN_3;
+			case PATTERN_ALTERNATE: buf[i] = (addr & 1) ? 0xAA : 0x55;
 				break;
-			case 4: pattern = PATTERN_4;
+			case PATTERN_INVERTED: buf[i] = ~addr & 0xFF;
 				break;
-			case 5: pattern = PATTERN_5;
+			case PATTERN_ZEROS: buf[i] = 0x00;
 				break;
-			case 6: pattern = PATTERN_6;
-				break;
-			default: pattern = PATTERN_1;
+			default: buf[i] = 0xFF;
 				break;
 		}
-		eeprom_write_byte(addr, pattern);
-
-		if (!eeprom_verify_byte(addr, pattern)) *errors = *errors + 1;
-
-		print_progress(addr - start);
 	}
+}
 
-	Serial.println();
-	if (*errors != 0) {
-		Serial.print(F("Test failed with "));
-		Serial.print(*errors);
-		Serial.println(F(" errors.\n"));
-	} else {
-		Serial.print(F("Testing "));
-		Serial.print(name);
-		Serial.println(F(" - Done.\n"));
+/**
+ * @brief Page data of the test job. With a March read element the page is first compared with the pattern the
+ * previous step wrote, the job then writes and verifies the new one.
+ */
+static void test_source(const uint16_t address, uint8_t *buf, const uint8_t len) {
+	const test_step &step = test_steps[test.step];
+	if (step.before != PATTERN_NONE) {
+		test_pattern(step.before, address, buf, len);
+		test.errors += eeprom_verify_block(address, buf, len);
 	}
+	test_pattern(step.write, address, buf, len);
 }
 
 /**
- * @brief Performs a test of the entire EEPROM memory using multiple test patterns.
- * This function divides the EEPROM into 6 equal segments and tests each segment with a different pattern:
- * - Segment 1: Walking 1's pattern
- * - Segment 2: Address as data pattern
- * - Segment 3: Alternating 0x55/0xAA pattern
- * - Segment 4: All zeros pattern
- * - Segment 5: All ones pattern
- * - Segment 6: Inverted address pattern
- *
- * @see eeprom_test_pattern() Used internally to test each segment
- * @see print_execution_time() Used to report the test duration
+ * @brief Get the first address of a block of the quick test.
+ * @param sample Block number, 0 to sample_blocks - 1
+ * @return EEPROM address
  */
-void eeprom_test() {
-	const unsigned long start_time = millis();
-	uint32_t errors = 0;
-
-	Serial.println();
-	Serial.println(F("Starting Full EEPROM Test"));
-	Serial.print(F("Testing "));
-	Serial.print(EEPROM_SIZE);
-	Serial.println(F(" bytes"));
+static uint16_t sample_address(const uint8_t sample) {
+	if (sample == 0) return 0;
+	if (sample == sample_blocks - 1) return EEPROM_SIZE - EEPROM_BLOCK_SIZE;
+	return EEPROM_BLOCK_SIZE << (sample - 1);
+}
 
-	// Calculate segment size for testing
-	// 6 different test patterns
-	constexpr uint16_t segment_size = EEPROM_SIZE / 6;
+static void test_done(const job_result *result);
 
-	// Test pattern 1: Walking 1's (first segment)
-	eeprom_test_pattern(0, segment_size, 1, F("Pattern 1: Walking 1's"), &errors);
+/**
+ * @brief Starts the job of the current step: the whole EEPROM, or the current block of the quick test. Every page
+ * is written, even if it already holds the pattern, and read back in one block.
+ */
+static void test_step_start() {
+	const test_step &step = test_steps[test.step];
+	if (test.sample == 0) {
+		Serial.print(F("Testing "));
+		Serial.println(test_name(test.step));
+	}
 
-	// Test pattern 2: Address as data (second segment)
-	eeprom_test_pattern(segment_size, segment_size * 2, 2, F("Pattern 2: Address as data"), &errors);
+	if (!test.quick) {
+		job_start('T', 0, EEPROM_SIZE, test_source, step.flags, test_done);
+		return;
+	}
 
-	// Test pattern 3: Alternating 0x55/0xAA (third segment)
-	eeprom_test_pattern(segment_size * 2, segment_size * 3, 3, F("Pattern 3: Alternating 0x55/0xAA"), &errors);
+	// Down elements take the blocks in reverse order
+	const uint8_t sample = (step.flags & JOB_DOWN) ? sample_blocks - 1 - test.sample : test.sample;
+	const uint16_t start = sample_address(sample);
+	job_start('T', start, start + EEPROM_BLOCK_SIZE, test_source, step.flags, test_done);
+}
 
-	// Test pattern 4: All zeros (fourth segment)
-	eeprom_test_pattern(segment_size * 3, segment_size * 4, 4, F("Pattern 4: All zeros"), &errors);
+/**
+ * @brief End of a job: continue with the next block or step, or print the final results.
+ */
+static void test_done(const job_result *result) {
+	test.errors += result->errors;
+
+	if (result->aborted) {
+		Serial.println();
+		Serial.println(F("EEPROM Test Aborted"));
+		print_execution_time(millis() - test.start_time);
+		return;
+	}
+	if (test.quick && ++test.sample < sample_blocks) {
+		test_step_start();
+		return;
+	}
+	test.sample = 0;
 
-	// Test pattern 5: All ones (fifth segment)
-	eeprom_test_pattern(segment_size * 4, segment_size * 5, 5, F("Pattern 5: All ones"), &errors);
+	Serial.println();
+	if (test.errors != 0) {
+		Serial.print(F("Test failed with "));
+		Serial.print(test.errors);
+		Serial.println(F(" errors.\n"));
+	} else {
+		Serial.print(F("Testing "));
+		Serial.print(test_name(test.step));
+		Serial.println(F(" - Done.\n"));
+	}
 
-	// Test pattern 6: Inverted address (last segment)
-	eeprom_test_pattern(segment_size * 5, EEPROM_SIZE, 6, F("Pattern 6: Inverted address"), &errors);
+	if (++test.step < TEST_STEPS) {
+		test_step_start();
+		return;
+	}
 
 	// Print final results
 	Serial.println(F("EEPROM Test Complete"));
 	Serial.print(F("Tested "));
-	Serial.print(EEPROM_SIZE);
+	Serial.print(test.quick ? sample_blocks * EEPROM_BLOCK_SIZE : EEPROM_SIZE);
 	Serial.println(F(" bytes\n"));
 
-	if (errors == 0) {
+	if (test.errors == 0) {
 		Serial.println(F("EEPROM test passed successfully!"));
 	} else {
 		Serial.print(F("Test failed with "));
-		Serial.print(errors);
+		Serial.print(test.errors);
 		Serial.println(F(" errors."));
 	}
 
-	print_execution_time(millis() - start_time);
+	print_execution_time(millis() - test.start_time);
+}
+
+/**
+ * @brief Performs a test of the EEPROM memory, as a chain of jobs run by job_step(). Every step writes its pattern
+ * with page writes and verifies it with block reads, the write cycles make up most of the test time:
+ * - Walking 1's, address as data, alternating 0x55/0xAA and inverted address over the whole EEPROM
+ * - March X address fault sequence: write 0x00, up check 0x00 write 0xFF, down check 0xFF write 0x00, check 0x00
+ * The quick test runs the same steps on the first block, one block per address line and the last block only.
+ * @param quick Only test the sampled blocks, for incoming inspection
+ *
+ * @see print_execution_time() Used to report the test duration
+ */
+void eeprom_test(const bool quick) {
+	test.start_time = millis();
+	test.errors = 0;
+	test.step = 0;
+	test.sample = 0;
+	test.quick = quick;
+
+	Serial.println();
+	Serial.println(quick ? F("Starting Quick EEPROM Test") : F("Starting Full EEPROM Test"));
+	Serial.print(F("Testing "));
+	Serial.print(quick ? sample_blocks * EEPROM_BLOCK_SIZE : EEPROM_SIZE);
+	Serial.println(F(" bytes"));
+
+	// The first step, the others follow when it is done
+	test_step_start();
 }
@@ -26,18 +26,15 @@
 #define EPROM_TEST_H
 
 /**
- * @brief Performs a test of the entire EEPROM memory using multiple test patterns.
- * This function divides the EEPROM into 6 equal segments and tests each segment with a different pattern:
- * - Segment 1: Walking 1's pattern
- * - Segment 2: Address as data pattern
- * - Segment 3: Alternating 0x55/0xAA pattern
- * - Segment 4: All zeros pattern
- * - Segment 5: All ones pattern
- * - Segment 6: Inverted address pattern
+ * @brief Performs a test of the EEPROM memory, as a chain of jobs run by job_step(). Every step writes its pattern
+ * with page writes and verifies it with block reads, the write cycles make up most of the test time:
+ * - Walking 1's, address as data, alternating 0x55/0xAA and inverted address over the whole EEPROM
+ * - March X address fault sequence: write 0x00, up check 0x00 write 0xFF, down check 0xFF write 0x00, check 0x00
+ * The quick test runs the same steps on the first block, one block per address line and the last block only.
+ * @param quick Only test the sampled blocks, for incoming inspection
  *
- * @see eeprom_test_pattern() Used internally to test each segment
  * @see print_execution_time() Used to report the test duration
  */
-void eeprom_test();
+void eeprom_test(bool quick);
 
 #endif //EPROM_TEST_H
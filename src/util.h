@@ -27,8 +27,6 @@
 
 inline void print_execution_time(unsigned long elapsed_time) __attribute__((always_inline));
 
-inline void print_progress(uint16_t addr) __attribute__((always_inline));
-
 inline uint8_t hex_char_to_int(char c) __attribute__((always_inline));
 
 inline uint32_t get_hex_value(uint8_t size, uint8_t empty) __attribute__((always_inline));
@@ -49,20 +47,6 @@ void print_execution_time(const unsigned long elapsed_time) {
 	Serial.println(F(" seconds"));
 }
 
-/**
- * @brief Print progress indicator
- * @param addr Current address
- */
-void print_progress(const uint16_t addr) {
-	if ((addr & 0x0F) == 0x0F) {
-		Serial.print(F("."));
-	}
-	// Check if we've hit 1024 bytes
-	if ((addr & 0x3FF) == 0x3FF) {
-		Serial.println();
-	}
-}
-
 /**
  * @brief Convert hex character to integer
  * @param c Hex character